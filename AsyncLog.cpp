@@ -0,0 +1,394 @@
+// AsyncLog.cpp
+#include "AsyncLog.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+using namespace drogon;
+
+namespace {
+
+const std::string kStartAttribute = "access_log_start_us";
+const std::string kUserAttribute = "access_log_user_id";
+
+int64_t steadyMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t wallMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char* methodName(uint8_t method) {
+    static const char* const kNames[] = {"GET", "POST", "HEAD", "PUT", "DELETE", "OPTIONS", "PATCH"};
+    return method < sizeof(kNames) / sizeof(kNames[0]) ? kNames[method] : "INVALID";
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// Line
+
+AsyncLog::Line& AsyncLog::Line::operator<<(std::string_view text) {
+    size_t length = std::min(text.size(), kTextBytes - _length);
+    std::memcpy(_text + _length, text.data(), length);
+    _length += length;
+    return *this;
+}
+
+AsyncLog::Line& AsyncLog::Line::operator<<(double value) {
+    // Same as the default ostream formatting (6 significant digits)
+    auto result = std::to_chars(_text + _length, _text + kTextBytes, value, std::chars_format::general, 6);
+    if (result.ec == std::errc()) _length = result.ptr - _text;
+    return *this;
+}
+
+AsyncLog::Line& AsyncLog::Line::appendSigned(long long value) {
+    auto result = std::to_chars(_text + _length, _text + kTextBytes, value);
+    if (result.ec == std::errc()) _length = result.ptr - _text;
+    return *this;
+}
+
+AsyncLog::Line& AsyncLog::Line::appendUnsigned(unsigned long long value) {
+    auto result = std::to_chars(_text + _length, _text + kTextBytes, value);
+    if (result.ec == std::errc()) _length = result.ptr - _text;
+    return *this;
+}
+
+// ---------------------------------------------------------------------------
+// Sink
+
+bool AsyncLog::Sink::open(const std::string& filePath) {
+    flush();
+    file.close();
+    path = filePath;
+    size = 0;
+    if (path.empty()) return true;
+
+    std::error_code ec;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    file.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        path.clear();
+        return false;
+    }
+    auto existing = std::filesystem::file_size(path, ec);
+    size = ec ? 0 : existing;
+    return true;
+}
+
+void AsyncLog::Sink::append(std::string_view line, uint64_t maxBytes, size_t maxFiles) {
+    if (!file.is_open()) return;
+    if (size > 0 && size + line.size() > maxBytes) rotate(maxFiles);
+    pending.append(line);
+    size += line.size();
+}
+
+void AsyncLog::Sink::flush() {
+    if (pending.empty() || !file.is_open()) return;
+    file.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+    file.flush();
+    pending.clear();
+}
+
+void AsyncLog::Sink::rotate(size_t maxFiles) {
+    flush();
+    file.close();
+
+    // name.<n-1> -> name.<n>, ..., name -> name.1; the oldest is overwritten
+    std::error_code ec;
+    if (maxFiles == 0) {
+        std::filesystem::remove(path, ec);
+    } else {
+        std::filesystem::remove(path + "." + std::to_string(maxFiles), ec);
+        for (size_t i = maxFiles - 1; i >= 1; --i) {
+            std::filesystem::rename(path + "." + std::to_string(i), path + "." + std::to_string(i + 1), ec);
+        }
+        std::filesystem::rename(path, path + ".1", ec);
+    }
+
+    file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    size = 0;
+}
+
+// ---------------------------------------------------------------------------
+// AsyncLog
+
+AsyncLog& AsyncLog::getInstance() {
+    static AsyncLog instance;
+    return instance;
+}
+
+AsyncLog::AsyncLog() {
+    for (size_t i = 0; i < kRingRecords; ++i) {
+        _ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _writer = std::thread([this]() { writerLoop(); });
+}
+
+AsyncLog::~AsyncLog() {
+    stop();
+}
+
+void AsyncLog::configure(const Json::Value& config) {
+    if (!config.isObject()) return;
+
+    std::string file = config.get("file", "").asString();
+    std::string accessLog = config.get("access_log", "").asString();
+    {
+        std::lock_guard<std::mutex> lock(_sinkMutex);
+        _console = config.get("console", true).asBool();
+        _maxFileBytes = std::max<uint64_t>(4096, config.get("max_file_bytes", 10 * 1024 * 1024).asUInt64());
+        _maxFiles = config.get("max_files", 5).asUInt();
+        if (!_file.open(file)) error() << "Cannot open log file: " << file;
+        if (!_accessFile.open(accessLog)) error() << "Cannot open access log: " << accessLog;
+        _accessEnabled = !_accessFile.path.empty();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        _flushInterval = std::chrono::milliseconds(std::max(1, config.get("flush_ms", 50).asInt()));
+    }
+
+    info() << "Logging: console " << (_console ? "on" : "off")
+           << ", file " << (file.empty() ? "off" : file)
+           << ", access log " << (_accessEnabled ? accessLog : "off");
+}
+
+void AsyncLog::installAccessLog() {
+    if (!_accessEnabled || _accessInstalled) return;
+    _accessInstalled = true;
+
+    app().registerPreRoutingAdvice([](const HttpRequestPtr& req) {
+        req->attributes()->insert(kStartAttribute, steadyMicros());
+    });
+
+    app().registerPostHandlingAdvice([this](const HttpRequestPtr& req, const HttpResponsePtr& resp) {
+        const auto& attributes = req->attributes();
+        if (!attributes->find(kStartAttribute)) return;
+        int userId = attributes->find(kUserAttribute) ? attributes->get<int>(kUserAttribute) : 0;
+        access(req->method(), req->path(), static_cast<int>(resp->statusCode()),
+               steadyMicros() - attributes->get<int64_t>(kStartAttribute), userId);
+    });
+}
+
+void AsyncLog::tagUser(const HttpRequestPtr& req, int userId) {
+    if (!getInstance()._accessEnabled) return;
+    req->attributes()->insert(kUserAttribute, userId);
+}
+
+AsyncLog::Record* AsyncLog::claim(uint64_t& position) {
+    position = _enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        auto& record = _ring[position & (kRingRecords - 1)];
+        uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+        auto lag = static_cast<int64_t>(sequence - position);
+        if (lag == 0) {
+            if (_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &record;
+            }
+        } else if (lag < 0) {
+            // The writer has not freed this slot yet: the ring is full
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void AsyncLog::publish(Record* record, uint64_t position) {
+    record->sequence.store(position + 1, std::memory_order_release);
+    // A burst fills the ring faster than flush_ms; wake the writer early
+    if ((position & (kWakeEvery - 1)) == kWakeEvery - 1) _writerWake.notify_one();
+}
+
+bool AsyncLog::enterProducer() {
+    // Sequentially consistent with stop(): either stop() sees this producer, or
+    // the producer sees _stopped and does not touch the ring
+    _producers.fetch_add(1);
+    if (!_stopped.load()) return true;
+    leaveProducer();
+    return false;
+}
+
+bool AsyncLog::write(Level level, std::string_view text) {
+    if (!enterProducer()) {
+        writeDirect(level, text);
+        return true;
+    }
+
+    uint64_t position;
+    Record* record = claim(position);
+    if (!record) {
+        leaveProducer();
+        return false;
+    }
+    record->timeUs = wallMicros();
+    record->kind = Kind::Message;
+    record->level = level;
+    record->length = static_cast<uint16_t>(std::min(text.size(), kTextBytes));
+    std::memcpy(record->text, text.data(), record->length);
+    publish(record, position);
+    leaveProducer();
+    return true;
+}
+
+bool AsyncLog::access(HttpMethod method, std::string_view path, int status, int64_t latencyUs, int userId) {
+    if (!enterProducer()) return false;
+
+    uint64_t position;
+    Record* record = claim(position);
+    if (!record) {
+        leaveProducer();
+        return false;
+    }
+    record->timeUs = wallMicros();
+    record->kind = Kind::Access;
+    record->level = Level::Info;
+    record->method = static_cast<uint8_t>(method);
+    record->status = static_cast<uint16_t>(status);
+    record->latencyUs = static_cast<uint32_t>(std::clamp<int64_t>(latencyUs, 0, UINT32_MAX));
+    record->userId = userId;
+    record->length = static_cast<uint16_t>(std::min(path.size(), kTextBytes));
+    std::memcpy(record->text, path.data(), record->length);
+    publish(record, position);
+    leaveProducer();
+    return true;
+}
+
+void AsyncLog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        if (!_writer.joinable()) return;
+        _stopping = true;
+    }
+    _stopped.store(true);
+    _writerWake.notify_all();
+    _writer.join();
+    // Producers that passed the _stopped check finish publishing in a few instructions
+    while (_producers.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    // Anything queued between the writer's last pass and _stopped
+    drain();
+}
+
+void AsyncLog::writerLoop() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopping) {
+        _writerWake.wait_for(lock, _flushInterval, [this]() { return _stopping; });
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+size_t AsyncLog::drain() {
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    std::string console;
+    std::string errors;
+    size_t written = 0;
+
+    for (;;) {
+        auto& record = _ring[_dequeuePos & (kRingRecords - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) break;
+        format(record, console, errors);
+        // Hand the slot back to producers for the next lap
+        record.sequence.store(_dequeuePos + kRingRecords, std::memory_order_release);
+        ++_dequeuePos;
+        ++written;
+    }
+
+    if (!console.empty()) {
+        std::fwrite(console.data(), 1, console.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (!errors.empty()) {
+        std::fwrite(errors.data(), 1, errors.size(), stderr);
+        std::fflush(stderr);
+    }
+    _file.flush();
+    _accessFile.flush();
+    _written.fetch_add(written, std::memory_order_relaxed);
+    return written;
+}
+
+void AsyncLog::format(const Record& record, std::string& console, std::string& errors) {
+    // "2026-01-01T00:00:00.123Z", the date part redone once a second
+    int64_t second = record.timeUs / 1000000;
+    if (second != _cachedSecond) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &time);
+#else
+        gmtime_r(&time, &utc);
+#endif
+        std::strftime(_cachedStamp, sizeof(_cachedStamp), "%Y-%m-%dT%H:%M:%S.", &utc);
+        _cachedSecond = second;
+    }
+    char millis[5];
+    std::snprintf(millis, sizeof(millis), "%03d", static_cast<int>(record.timeUs / 1000 % 1000));
+
+    std::string line;
+    line.reserve(64 + record.length);
+    line += _cachedStamp;
+    line += millis;
+    line += 'Z';
+    std::string_view text(record.text, record.length);
+
+    if (record.kind == Kind::Access) {
+        // 2026-01-01T00:00:00.123Z GET /api/me 200 1834us uid=42
+        line += ' ';
+        line += methodName(record.method);
+        line += ' ';
+        line += text;
+        line += ' ';
+        appendNumber(line, record.status);
+        line += ' ';
+        appendNumber(line, record.latencyUs);
+        line += "us uid=";
+        if (record.userId) {
+            appendNumber(line, record.userId);
+        } else {
+            line += '-';
+        }
+        line += '\n';
+        _accessFile.append(line, _maxFileBytes, _maxFiles);
+        return;
+    }
+
+    // The console keeps the messages as they were printed before; files get one
+    // timestamped line each
+    if (_console) {
+        auto& out = record.level == Level::Error ? errors : console;
+        out += text;
+        out += '\n';
+    }
+    if (_file.file.is_open()) {
+        size_t start = text.find_first_not_of('\n');
+        line += record.level == Level::Error ? " ERROR " : " INFO  ";
+        line += start == std::string_view::npos ? std::string_view() : text.substr(start);
+        line += '\n';
+        _file.append(line, _maxFileBytes, _maxFiles);
+    }
+}
+
+void AsyncLog::writeDirect(Level level, std::string_view text) {
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    if (!_console) return;
+    auto& out = level == Level::Error ? std::cerr : std::cout;
+    out << text << std::endl;
+}
@@ -0,0 +1,176 @@
+// AsyncLog.h
+#pragma once
+#include <drogon/drogon.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Application log and per-request access log, written by one background thread.
+// A caller formats its line (or fills a binary access record) into a slot of a
+// bounded lock-free ring and returns; the writer drains the ring every flush_ms
+// to the console and to size-rotated files. When the ring is full the record is
+// dropped and counted, so a slow disk never holds up a request.
+//
+//   AsyncLog::info() << "Loaded " << count << " users";
+//
+// Lines longer than a slot (kTextBytes) are cut short.
+class AsyncLog {
+public:
+    enum class Level : uint8_t { Info, Error };
+
+    static constexpr size_t kTextBytes = 224;
+
+    // One log line, queued when it goes out of scope
+    class Line {
+    public:
+        explicit Line(Level level) : _level(level) {}
+        ~Line() { AsyncLog::getInstance().write(_level, std::string_view(_text, _length)); }
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+        Line& operator<<(std::string_view text);
+        Line& operator<<(const char* text) { return *this << std::string_view(text); }
+        Line& operator<<(const std::string& text) { return *this << std::string_view(text); }
+        Line& operator<<(char c) { return *this << std::string_view(&c, 1); }
+        Line& operator<<(double value);
+
+        template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+        Line& operator<<(T value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                return *this << (value ? "true" : "false");
+            } else if constexpr (std::is_signed_v<T>) {
+                return appendSigned(value);
+            } else {
+                return appendUnsigned(value);
+            }
+        }
+
+    private:
+        Line& appendSigned(long long value);
+        Line& appendUnsigned(unsigned long long value);
+
+        Level _level;
+        size_t _length = 0;
+        char _text[kTextBytes];
+    };
+
+    // Singleton instance; the writer thread starts with it, logging to the console
+    static AsyncLog& getInstance();
+
+    ~AsyncLog();
+
+    static Line info() { return Line(Level::Info); }
+    static Line error() { return Line(Level::Error); }
+
+    // Configure from a config section:
+    //   { "console": true, "file": "logs/app.log", "access_log": "logs/access.log",
+    //     "max_file_bytes": 10485760, "max_files": 5, "flush_ms": 50 }
+    // An empty file name turns that file off. A file is rotated to name.1 ...
+    // name.<max_files> when it would grow past max_file_bytes.
+    void configure(const Json::Value& config);
+
+    // Register the advices that write one access record per request
+    void installAccessLog();
+
+    // Remember the authenticated user for the request's access record
+    static void tagUser(const drogon::HttpRequestPtr& req, int userId);
+
+    // Queue a message line or an access record; false if the ring was full
+    bool write(Level level, std::string_view text);
+    bool access(drogon::HttpMethod method, std::string_view path, int status, int64_t latencyUs, int userId);
+
+    // Write out what is queued and stop the writer; later lines go straight to the console
+    void stop();
+
+    uint64_t writtenCount() const { return _written.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kRingRecords = 16384;              // Power of two
+    static constexpr size_t kWakeEvery = kRingRecords / 4;     // Records between early writer wake-ups
+
+    enum class Kind : uint8_t { Message, Access };
+
+    // One ring slot. sequence says whose turn it is: producers claim a slot when it
+    // equals their position, the writer reads it once it is position + 1.
+    struct alignas(64) Record {
+        std::atomic<uint64_t> sequence{0};
+        int64_t timeUs = 0;             // Wall clock, since the epoch
+        Kind kind = Kind::Message;
+        Level level = Level::Info;
+        uint16_t length = 0;            // Of text: the message, or the access path
+        uint8_t method = 0;
+        uint16_t status = 0;
+        uint32_t latencyUs = 0;
+        int32_t userId = 0;
+        char text[kTextBytes];
+    };
+    static_assert(sizeof(Record) == 256, "a record is four cache lines");
+
+    // A log file with size-based rotation; only touched by whoever drains the ring
+    struct Sink {
+        std::string path;
+        std::ofstream file;
+        uint64_t size = 0;
+        std::string pending;
+
+        bool open(const std::string& filePath);
+        void append(std::string_view line, uint64_t maxBytes, size_t maxFiles);
+        void flush();
+        void rotate(size_t maxFiles);
+    };
+
+    AsyncLog();
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    // Count a producer in flight so stop() can wait for it; false once stopped
+    bool enterProducer();
+    void leaveProducer() { _producers.fetch_sub(1, std::memory_order_release); }
+
+    // Claim the next free slot, or null when the ring is full
+    Record* claim(uint64_t& position);
+    void publish(Record* record, uint64_t position);
+
+    void writerLoop();
+
+    // Format and write everything queued; returns the number of records written
+    size_t drain();
+    void format(const Record& record, std::string& console, std::string& errors);
+    void writeDirect(Level level, std::string_view text);
+
+    std::array<Record, kRingRecords> _ring;
+    alignas(64) std::atomic<uint64_t> _enqueuePos{0};
+    alignas(64) uint64_t _dequeuePos = 0;              // Writer only
+
+    std::mutex _sinkMutex;                              // Sinks and settings below
+    bool _console = true;
+    Sink _file;
+    Sink _accessFile;
+    uint64_t _maxFileBytes = 10 * 1024 * 1024;
+    size_t _maxFiles = 5;
+    int64_t _cachedSecond = -1;
+    char _cachedStamp[24] = {};                         // "2026-01-01T00:00:00." for _cachedSecond
+
+    bool _accessEnabled = false;
+    bool _accessInstalled = false;
+
+    std::mutex _writerMutex;
+    std::condition_variable _writerWake;
+    std::chrono::milliseconds _flushInterval{50};
+    std::atomic<bool> _stopped{false};
+    std::atomic<uint32_t> _producers{0};                // Past the _stopped check, not yet published
+    bool _stopping = false;
+    std::thread _writer;
+
+    std::atomic<uint64_t> _written{0};
+    std::atomic<uint64_t> _dropped{0};
+};
@@ -0,0 +1,125 @@
+// ConfigReloader.cpp
+#include "ConfigReloader.h"
+#include "AsyncLog.h"
+#include "DatabaseConfig.h"
+#include <algorithm>
+#include <csignal>
+#include <fstream>
+
+namespace {
+
+volatile std::sig_atomic_t hangupReceived = 0;
+
+#ifndef _WIN32
+void onHangup(int) {
+    hangupReceived = 1;
+}
+#endif
+
+bool readConfig(const std::string& path, Json::Value& config) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    Json::CharReaderBuilder readerBuilder;
+    std::string errors;
+    return Json::parseFromStream(readerBuilder, file, &config, &errors);
+}
+
+Json::Value restartSections(const Json::Value& config) {
+    Json::Value sections(Json::objectValue);
+    sections["listeners"] = config["listeners"];
+    sections["app"] = config["app"];
+    return sections;
+}
+
+}
+
+ConfigReloader& ConfigReloader::getInstance() {
+    static ConfigReloader instance;
+    return instance;
+}
+
+ConfigReloader::~ConfigReloader() {
+    if (_worker.joinable()) _worker.join();
+}
+
+void ConfigReloader::start(const Json::Value& config) {
+    _path = DatabaseConfig::getInstance().getConfigPath();
+    if (_path.empty()) {
+        AsyncLog::info() << "Config reload: no config file loaded, disabled";
+        return;
+    }
+
+    _watchFile = config.get("watch_file", true).asBool();
+    _drain = std::chrono::seconds(std::max(0, config.get("drain_seconds", 30).asInt()));
+
+    std::error_code error;
+    _seenWriteTime = std::filesystem::last_write_time(_path, error);
+    Json::Value current;
+    if (readConfig(_path, current)) _restartSections = restartSections(current);
+
+#ifndef _WIN32
+    std::signal(SIGHUP, onHangup);
+#endif
+    drogon::app().getLoop()->runEvery(1.0, [this]() { tick(); });
+
+    std::string triggers = _watchFile ? "file watch" : "";
+#ifndef _WIN32
+    triggers += triggers.empty() ? "SIGHUP" : ", SIGHUP";
+#endif
+    AsyncLog::info() << "Config reload: " << _path << " (" << (triggers.empty() ? "manual only" : triggers)
+                     << "), drain " << _drain.count() << " s";
+}
+
+void ConfigReloader::tick() {
+    if (hangupReceived) {
+        hangupReceived = 0;
+        requestReload();
+    }
+    if (_watchFile && fileSettled()) {
+        requestReload();
+    }
+
+    if (!_running.load(std::memory_order_acquire)) {
+        if (_worker.joinable()) _worker.join();
+        if (_requested.exchange(false, std::memory_order_relaxed)) {
+            _running.store(true, std::memory_order_release);
+            _worker = std::thread([this]() {
+                run();
+                _running.store(false, std::memory_order_release);
+            });
+        }
+    }
+
+    DatabaseConfig::getInstance().releaseRetired(_drain);
+}
+
+bool ConfigReloader::fileSettled() {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(_path, error);
+    if (error) return false;
+    if (writeTime != _seenWriteTime) {
+        // Still being written, or just saved: wait for a quiet tick
+        _seenWriteTime = writeTime;
+        _writePending = true;
+        return false;
+    }
+    if (!_writePending) return false;
+    _writePending = false;
+    return true;
+}
+
+void ConfigReloader::run() {
+    AsyncLog::info() << "Config reload: started";
+    auto started = std::chrono::steady_clock::now();
+
+    Json::Value config;
+    if (readConfig(_path, config) && restartSections(config) != _restartSections) {
+        AsyncLog::error() << "Config reload: \"listeners\"/\"app\" changed; restart to apply them";
+    }
+
+    bool ok = DatabaseConfig::getInstance().reload();
+    (ok ? _reloads : _failed).fetch_add(1, std::memory_order_relaxed);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    AsyncLog::info() << "Config reload: " << (ok ? "applied" : "failed") << " in " << ms << " ms";
+}
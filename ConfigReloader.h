@@ -0,0 +1,63 @@
+// ConfigReloader.h
+#pragma once
+#include <drogon/drogon.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+// Applies config.json changes without a restart. A reload is requested by SIGHUP
+// (not on Windows), by a change to the file's modification time, or by
+// requestReload(). DatabaseConfig::reload() then runs on a background thread
+// while the current clients keep serving, and the clients it replaces are
+// released once their drain period has passed.
+//
+// Only the database clients are reloaded. Drogon cannot rebind listeners or
+// change "app" settings on a running server, so changes there are reported as
+// needing a restart.
+class ConfigReloader {
+public:
+    // Singleton instance
+    static ConfigReloader& getInstance();
+
+    // Start watching the file DatabaseConfig loaded. Config section:
+    //   { "watch_file": true, "drain_seconds": 30 }
+    // drain_seconds should exceed the longest query the app runs.
+    void start(const Json::Value& config);
+
+    // Ask for a reload from any thread; picked up on the next tick
+    void requestReload() { _requested.store(true, std::memory_order_relaxed); }
+
+    uint64_t reloadCount() const { return _reloads.load(std::memory_order_relaxed); }
+    uint64_t failedCount() const { return _failed.load(std::memory_order_relaxed); }
+
+private:
+    ConfigReloader() = default;
+    ~ConfigReloader();
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+
+    // Once a second on the main loop: start a pending reload, release drained clients
+    void tick();
+
+    // Body of the background reload
+    void run();
+
+    // True if the file changed and then stayed unchanged for a whole tick
+    bool fileSettled();
+
+    std::string _path;
+    bool _watchFile = true;
+    std::chrono::seconds _drain{30};
+    std::filesystem::file_time_type _seenWriteTime{};
+    bool _writePending = false;
+    Json::Value _restartSections;               // "listeners" and "app" as the server started with
+
+    std::atomic<bool> _requested{false};
+    std::atomic<bool> _running{false};
+    std::thread _worker;
+    std::atomic<uint64_t> _reloads{0};
+    std::atomic<uint64_t> _failed{0};
+};
@@ -1,15 +1,120 @@
 // DatabaseConfig.cpp
 #include "DatabaseConfig.h"
+#include "AsyncLog.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <filesystem>
+#include <future>
+#include <set>
 #include <sstream>
-#include <iostream>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long startup waits for a client's pool to come up
+constexpr double kWarmupTimeoutSeconds = 10.0;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct WarmResult {
+    bool ok = false;
+    size_t opened = 0;        // Distinct backend connections seen
+    double firstMs = 0;       // First answer (TCP + TLS + auth of one connection)
+    double allMs = 0;         // Every pooled connection answered
+    std::string version;
+    std::string error;
+};
+
+// Open every pooled connection before the listener accepts traffic. Queries are
+// issued `connections` at a time; once they have landed on that many distinct
+// backend pids, the whole pool is connected.
+WarmResult warmClient(const std::shared_ptr<drogon::orm::DbClient>& client, size_t connections) {
+    struct Answer {
+        int pid = -1;
+        std::string version;
+        std::string error;
+    };
+
+    WarmResult result;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(kWarmupTimeoutSeconds));
+    std::set<int> pids;
+
+    while (true) {
+        std::vector<std::future<Answer>> answers;
+        for (size_t i = 0; i < connections; ++i) {
+            auto promise = std::make_shared<std::promise<Answer>>();
+            answers.push_back(promise->get_future());
+            client->execSqlAsync(
+                "SELECT pg_backend_pid() AS pid, version() AS version",
+                [promise](const drogon::orm::Result& r) {
+                    Answer answer;
+                    answer.pid = r[0]["pid"].as<int>();
+                    answer.version = r[0]["version"].as<std::string>();
+                    promise->set_value(std::move(answer));
+                },
+                [promise](const drogon::orm::DrogonDbException& e) {
+                    Answer answer;
+                    answer.error = e.base().what();
+                    promise->set_value(std::move(answer));
+                });
+        }
+
+        for (auto& future : answers) {
+            if (future.wait_until(deadline) != std::future_status::ready) {
+                if (result.error.empty()) result.error = "timed out";
+                continue;
+            }
+            auto answer = future.get();
+            if (answer.pid < 0) {
+                if (result.error.empty()) result.error = answer.error;
+                continue;
+            }
+            if (pids.empty()) {
+                result.firstMs = millisecondsSince(start);
+                result.version = answer.version;
+            }
+            pids.insert(answer.pid);
+        }
+
+        result.opened = pids.size();
+        result.ok = !pids.empty();
+        if (pids.size() >= connections) {
+            result.allMs = millisecondsSince(start);
+            result.error.clear();
+            return result;
+        }
+        if (Clock::now() >= deadline) {
+            return result;
+        }
+        // Some connections are still handshaking; queries doubled up on the ready ones
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+}
 
 DatabaseConfig& DatabaseConfig::getInstance() {
     static DatabaseConfig instance;
     return instance;
 }
 
+DatabaseConfig::DatabaseConfig()
+    : _registry(std::make_shared<const Registry>()) {
+}
+
+const DatabaseConfig::Entry* DatabaseConfig::Registry::find(const std::string& name) const {
+    auto it = std::lower_bound(clients.begin(), clients.end(), name,
+                               [](const Entry& entry, const std::string& key) { return entry.name < key; });
+    return (it != clients.end() && it->name == name) ? &*it : nullptr;
+}
+
 std::string DatabaseConfig::findConfigFile(const std::string& filename) {
     // Try multiple possible locations
     std::vector<std::string> possiblePaths = {
@@ -22,23 +127,23 @@ std::string DatabaseConfig::findConfigFile(const std::string& filename) {
     
     for (const auto& tryPath : possiblePaths) {
         if (std::filesystem::exists(tryPath)) {
-            std::cout << "Found config file at: " << tryPath << std::endl;
+            AsyncLog::info() << "Found config file at: " << tryPath;
             return tryPath;
         }
     }
     
-    std::cerr << "Could not find " << filename << ". Tried:" << std::endl;
+    AsyncLog::error() << "Could not find " << filename << ". Tried:";
     for (const auto& tryPath : possiblePaths) {
-        std::cerr << "  - " << tryPath << std::endl;
+        AsyncLog::error() << "  - " << tryPath;
     }
     
     return "";
 }
 
-bool DatabaseConfig::loadConfigFile(const std::string& path) {
+bool DatabaseConfig::loadConfigFile(const std::string& path, Registry& registry) {
     std::ifstream file(path);
     if (!file.is_open()) {
-        std::cerr << "Cannot open config file: " << path << std::endl;
+        AsyncLog::error() << "Cannot open config file: " << path;
         return false;
     }
     
@@ -46,7 +151,8 @@ bool DatabaseConfig::loadConfigFile(const std::string& path) {
     buffer << file.rdbuf();
     file.close();
     
-    std::cout << "Loading configuration from: " << path << std::endl;
+    AsyncLog::info() << "Loading configuration from: " << path;
+    auto parseStart = Clock::now();
     
     try {
         Json::Value config;
@@ -55,9 +161,10 @@ bool DatabaseConfig::loadConfigFile(const std::string& path) {
         
         std::istringstream jsonStream(buffer.str());
         if (!Json::parseFromStream(readerBuilder, jsonStream, &config, &errors)) {
-            std::cerr << "Failed to parse JSON: " << errors << std::endl;
+            AsyncLog::error() << "Failed to parse JSON: " << errors;
             return false;
         }
+        AsyncLog::info() << "Config parsed in " << millisecondsSince(parseStart) << " ms";
         
         // Look for database configuration in different possible keys
         std::vector<std::string> possibleKeys = {"dbs", "db_clients", "databases"};
@@ -65,8 +172,8 @@ bool DatabaseConfig::loadConfigFile(const std::string& path) {
         
         for (const auto& key : possibleKeys) {
             if (config.isMember(key) && config[key].isArray()) {
-                std::cout << "Found database configuration under key: " << key << std::endl;
-                if (parseDatabaseConfig(config[key])) {
+                AsyncLog::info() << "Found database configuration under key: " << key;
+                if (parseDatabaseConfig(config[key], registry)) {
                     foundDbConfig = true;
                     break; // Stop after first successful parse
                 }
@@ -74,8 +181,8 @@ bool DatabaseConfig::loadConfigFile(const std::string& path) {
         }
         
         if (!foundDbConfig) {
-            std::cout << "No database configuration found in config.json" << std::endl;
-            std::cout << "Tried keys: dbs, db_clients, databases" << std::endl;
+            AsyncLog::info() << "No database configuration found in config.json";
+            AsyncLog::info() << "Tried keys: dbs, db_clients, databases";
             // Don't return false here - server can run without DB
         }
         
@@ -83,19 +190,17 @@ bool DatabaseConfig::loadConfigFile(const std::string& path) {
         return true;
         
     } catch (const std::exception& e) {
-        std::cerr << "Error loading config file: " << e.what() << std::endl;
+        AsyncLog::error() << "Error loading config file: " << e.what();
         return false;
     }
 }
 
-bool DatabaseConfig::parseDatabaseConfig(const Json::Value& dbConfig) {
+bool DatabaseConfig::parseDatabaseConfig(const Json::Value& dbConfig, Registry& registry) {
     if (!dbConfig.isArray()) {
-        std::cerr << "Database config is not an array" << std::endl;
+        AsyncLog::error() << "Database config is not an array";
         return false;
     }
     
-    bool success = false;
-    
     for (const auto& db : dbConfig) {
         if (!db.isObject()) continue;
         
@@ -105,32 +210,85 @@ bool DatabaseConfig::parseDatabaseConfig(const Json::Value& dbConfig) {
             name = db["name"].asString();
         }
         
-        std::cout << "Parsing database config for: " << name << std::endl;
+        AsyncLog::info() << "Parsing database config for: " << name;
         
-        if (createDatabaseClient(name, db)) {
-            success = true;
+        if (!createDatabaseClient(name, db, registry)) {
+            ++registry.failed;
+        }
+    }
+    
+    // Clients connect in the background as soon as they are created; warm them
+    // all at once so startup costs the slowest handshake, not the sum of them.
+    // Clients carried over by a reload are already connected.
+    std::vector<std::future<WarmResult>> warming;
+    for (const auto& entry : registry.clients) {
+        if (entry.reused) {
+            warming.emplace_back();
+            continue;
+        }
+        warming.push_back(std::async(std::launch::async, warmClient, entry.client, entry.connections));
+    }
+    
+    std::vector<Entry> connected;
+    for (size_t i = 0; i < registry.clients.size(); ++i) {
+        auto& entry = registry.clients[i];
+        if (entry.reused) {
+            AsyncLog::info() << "✓ Database kept: " << entry.name << " (settings unchanged, pool stays open)";
+        } else {
+            auto warm = warming[i].get();
+            if (!warm.ok) {
+                AsyncLog::error() << "✗ Database connection failed: " << entry.name << " - " << warm.error;
+                ++registry.failed;
+                continue;
+            }
             
-            // Set as default if it's the first one or explicitly named "default"
-            if (name == "default" || !_defaultClient) {
-                _defaultClient = _dbClients[name];
+            AsyncLog::info() << "✓ Database connected: " << entry.name << " - PostgreSQL "
+                             << warm.version.substr(0, 50);
+            auto line = AsyncLog::info();
+            line << "  first connection " << warm.firstMs << " ms, ";
+            if (warm.opened >= entry.connections) {
+                line << "all " << entry.connections << " connection(s) " << warm.allMs << " ms";
+            } else {
+                line << "only " << warm.opened << "/" << entry.connections
+                     << " connection(s) open after " << kWarmupTimeoutSeconds << " s";
             }
         }
+        
+        // Set as default if it's the first primary or explicitly named "default"
+        if (!entry.replica && (entry.name == "default" || !registry.defaultClient)) {
+            registry.defaultClient = entry.client;
+        }
+        connected.push_back(std::move(entry));
     }
     
-    return success;
+    registry.clients = std::move(connected);
+    registry.replicas.clear();
+    for (const auto& entry : registry.clients) {
+        if (entry.replica) registry.replicas.push_back(entry.replica);
+    }
+    
+    return !registry.clients.empty();
 }
 
-bool DatabaseConfig::createDatabaseClient(const std::string& name, const Json::Value& config) {
+bool DatabaseConfig::createDatabaseClient(const std::string& name, const Json::Value& config,
+                                          Registry& registry) {
     try {
         // Check for required fields
         if (!config.isMember("rdbms") || !config["rdbms"].isString()) {
-            std::cerr << "Missing or invalid 'rdbms' field for database: " << name << std::endl;
+            AsyncLog::error() << "Missing or invalid 'rdbms' field for database: " << name;
+            return false;
+        }
+        
+        std::string role = config.get("role", "primary").asString();
+        if (role != "primary" && role != "replica") {
+            AsyncLog::error() << "Invalid role '" << role << "' for database: " << name
+                              << " (expected primary or replica)";
             return false;
         }
         
         std::string rdbms = config["rdbms"].asString();
         if (rdbms != "postgresql") {
-            std::cerr << "Unsupported database type: " << rdbms << " for: " << name << std::endl;
+            AsyncLog::error() << "Unsupported database type: " << rdbms << " for: " << name;
             return false;
         }
         
@@ -145,7 +303,7 @@ bool DatabaseConfig::createDatabaseClient(const std::string& name, const Json::V
             if (!config.isMember("host") || !config.isMember("port") || 
                 !config.isMember("dbname") || !config.isMember("user") || 
                 !config.isMember("passwd")) {
-                std::cerr << "Missing required database parameters for: " << name << std::endl;
+                AsyncLog::error() << "Missing required database parameters for: " << name;
                 return false;
             }
             
@@ -172,28 +330,59 @@ bool DatabaseConfig::createDatabaseClient(const std::string& name, const Json::V
             connectionNum = config["number_of_connections"].asUInt();
         }
         
-        std::cout << "Creating PostgreSQL client for: " << name << std::endl;
-        std::cout << "Connection string (password hidden): " 
-                  << connString.substr(0, connString.find("password=") + 9) << "*******" << std::endl;
+        AsyncLog::info() << "Creating PostgreSQL client for: " << name << " (" << role << ")";
+        AsyncLog::info() << "Connection string (password hidden): " 
+                         << connString.substr(0, connString.find("password=") + 9) << "*******";
         
         #ifdef USE_POSTGRESQL
-            auto client = drogon::orm::DbClient::newPgClient(connString, connectionNum);
+            Entry entry;
+            entry.name = name;
+            entry.connections = connectionNum;
+            entry.connInfo = connString;
             
-            // Test connection
-            auto result = client->execSqlSync("SELECT version()");
-            std::cout << "✓ Database connected: " << name << " - PostgreSQL " 
-                      << result[0]["version"].as<std::string>().substr(0, 50) << std::endl;
+            // On reload, a client whose settings did not change keeps its connected pool
+            auto current = this->current();
+            const auto* previous = current->find(name);
+            if (previous && previous->connInfo == connString && previous->connections == connectionNum &&
+                static_cast<bool>(previous->replica) == (role == "replica")) {
+                entry.client = previous->client;
+                entry.reused = true;
+            } else {
+                // Connects asynchronously; parseDatabaseConfig waits for the pool
+                entry.client = drogon::orm::DbClient::newPgClient(connString, connectionNum);
+            }
+            
+            if (role == "replica") {
+                auto replica = std::make_shared<Replica>();
+                replica->name = name;
+                replica->client = entry.client;
+                if (config["max_lag_seconds"].isNumeric()) {
+                    replica->maxLagSeconds = config["max_lag_seconds"].asDouble();
+                }
+                if (entry.reused) {
+                    // Same backend: keep its health until the next probe
+                    replica->usable.store(previous->replica->usable.load());
+                    replica->lagSeconds.store(previous->replica->lagSeconds.load());
+                }
+                entry.replica = replica;
+                registry.replicas.push_back(std::move(replica));
+            }
             
-            _dbClients[name] = client;
+            // A later entry with the same name replaces the earlier one
+            registry.clients.erase(
+                std::remove_if(registry.clients.begin(), registry.clients.end(),
+                               [&name](const Entry& e) { return e.name == name; }),
+                registry.clients.end());
+            registry.clients.push_back(std::move(entry));
             return true;
             
         #else
-            std::cerr << "PostgreSQL support not compiled in!" << std::endl;
+            AsyncLog::error() << "PostgreSQL support not compiled in!";
             return false;
         #endif
         
     } catch (const std::exception& e) {
-        std::cerr << "Failed to create database client '" << name << "': " << e.what() << std::endl;
+        AsyncLog::error() << "Failed to create database client '" << name << "': " << e.what();
         return false;
     }
 }
@@ -203,75 +392,248 @@ bool DatabaseConfig::initialize() {
 }
 
 bool DatabaseConfig::initialize(const std::string& configPath) {
-    if (_initialized) {
-        std::cout << "Database already initialized" << std::endl;
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    if (_initialized.load(std::memory_order_acquire)) {
+        AsyncLog::info() << "Database already initialized";
         return true;
     }
     
-    std::cout << "Initializing database configuration..." << std::endl;
+    AsyncLog::info() << "Initializing database configuration...";
     
     std::string foundPath = configPath;
     if (configPath == "config.json") {
         foundPath = findConfigFile();
         if (foundPath.empty()) {
-            std::cerr << "Cannot find config.json" << std::endl;
+            AsyncLog::error() << "Cannot find config.json";
             // Still mark as initialized to avoid repeated errors
-            _initialized = true;
+            _initialized.store(true, std::memory_order_release);
             return false;
         }
     }
     
-    if (!loadConfigFile(foundPath)) {
-        std::cerr << "Failed to load configuration from: " << foundPath << std::endl;
+    auto registry = std::make_shared<Registry>();
+    if (!loadConfigFile(foundPath, *registry)) {
+        AsyncLog::error() << "Failed to load configuration from: " << foundPath;
         // Still mark as initialized to avoid repeated errors
-        _initialized = true;
+        _initialized.store(true, std::memory_order_release);
         return false;
     }
     
-    if (_dbClients.empty()) {
-        std::cout << "No database clients created (server will run without DB)" << std::endl;
+    if (registry->clients.empty()) {
+        AsyncLog::info() << "No database clients created (server will run without DB)";
     } else {
-        std::cout << "Database configuration initialized successfully with " 
-                  << _dbClients.size() << " client(s)" << std::endl;
+        AsyncLog::info() << "Database configuration initialized successfully with " 
+                         << registry->clients.size() << " client(s)";
     }
     
-    _initialized = true;
+    publish(std::move(registry));
+    _initialized.store(true, std::memory_order_release);
     return true;
 }
 
-std::shared_ptr<drogon::orm::DbClient> DatabaseConfig::getClient() {
-    if (!_initialized) {
-        // Auto-initialize if not already initialized
-        std::cout << "Auto-initializing database configuration..." << std::endl;
-        if (!initialize()) {
-            std::cerr << "Auto-initialization failed" << std::endl;
-            return nullptr;
+bool DatabaseConfig::reload() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    if (_configPath.empty()) {
+        AsyncLog::error() << "Cannot reload database configuration: no config file loaded";
+        return false;
+    }
+    
+    AsyncLog::info() << "Reloading database configuration from: " << _configPath;
+    
+    auto registry = std::make_shared<Registry>();
+    if (!loadConfigFile(_configPath, *registry)) {
+        AsyncLog::error() << "Reload failed, keeping current database clients";
+        return false;
+    }
+    
+    // All or nothing: a typo in one entry must not take that database away
+    if (registry->failed > 0) {
+        AsyncLog::error() << "Reload failed: " << registry->failed
+                          << " client(s) did not connect, keeping current database clients";
+        return false;
+    }
+    
+    size_t reused = std::count_if(registry->clients.begin(), registry->clients.end(),
+                                  [](const Entry& entry) { return entry.reused; });
+    AsyncLog::info() << "Database configuration reloaded: " << registry->clients.size() << " client(s), "
+                     << reused << " kept, " << registry->clients.size() - reused << " new";
+    publish(std::move(registry));
+    return true;
+}
+
+void DatabaseConfig::releaseRetired(std::chrono::seconds drain) {
+    std::vector<std::shared_ptr<const Registry>> released;
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        auto cutoff = Clock::now() - drain;
+        auto it = std::partition(_retired.begin(), _retired.end(),
+                                 [cutoff](const auto& retired) { return retired.first > cutoff; });
+        for (auto old = it; old != _retired.end(); ++old) released.push_back(std::move(old->second));
+        _retired.erase(it, _retired.end());
+    }
+    if (released.empty()) return;
+    
+    // Pools the current snapshot does not share close when `released` goes out of scope
+    auto live = current();
+    for (const auto& registry : released) {
+        for (const auto& entry : registry->clients) {
+            bool shared = std::any_of(live->clients.begin(), live->clients.end(),
+                                      [&entry](const Entry& e) { return e.client == entry.client; });
+            if (!shared) {
+                AsyncLog::info() << "Closing drained database client: " << entry.name;
+            }
         }
     }
+}
+
+size_t DatabaseConfig::retiredCount() const {
+    std::lock_guard<std::mutex> lock(_retiredMutex);
+    return _retired.size();
+}
+
+void DatabaseConfig::publish(std::shared_ptr<Registry> registry) {
+    std::sort(registry->clients.begin(), registry->clients.end(),
+              [](const Entry& a, const Entry& b) { return a.name < b.name; });
     
-    if (!_defaultClient && !_dbClients.empty()) {
+    if (!registry->defaultClient && !registry->clients.empty()) {
         // Use the first client if no default is set
-        _defaultClient = _dbClients.begin()->second;
+        registry->defaultClient = registry->clients.front().client;
     }
     
-    return _defaultClient;
+    registry->generation = _generation.load(std::memory_order_relaxed) + 1;
+    uint64_t generation = registry->generation;
+    auto previous = std::atomic_exchange_explicit(
+        &_registry, std::shared_ptr<const Registry>(std::move(registry)), std::memory_order_acq_rel);
+    _generation.store(generation, std::memory_order_release);
+    
+    // Threads may still be running queries on the old clients; releaseRetired() frees them later
+    std::lock_guard<std::mutex> lock(_retiredMutex);
+    _retired.emplace_back(Clock::now(), std::move(previous));
+}
+
+const DatabaseConfig::Registry& DatabaseConfig::registry() const {
+    // Steady state is a single atomic load per lookup. The cache is a plain
+    // pointer so an idle thread does not pin an old snapshot (and its pools):
+    // _registry or _retired owns whatever it points to, and it is only
+    // dereferenced while its generation is current. Callers must not hold the
+    // returned reference across another registry() call.
+    thread_local const Registry* cached = nullptr;
+    thread_local uint64_t cachedGeneration = 0;
+    uint64_t generation = _generation.load(std::memory_order_acquire);
+    if (!cached || cachedGeneration != generation) {
+        cached = std::atomic_load_explicit(&_registry, std::memory_order_acquire).get();
+        cachedGeneration = generation;
+    }
+    return *cached;
+}
+
+std::shared_ptr<const DatabaseConfig::Registry> DatabaseConfig::current() const {
+    return std::atomic_load_explicit(&_registry, std::memory_order_acquire);
+}
+
+bool DatabaseConfig::ensureInitialized() {
+    if (_initialized.load(std::memory_order_acquire)) return true;
+    
+    // Auto-initialize if not already initialized
+    AsyncLog::info() << "Auto-initializing database configuration...";
+    if (!initialize()) {
+        AsyncLog::error() << "Auto-initialization failed";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<drogon::orm::DbClient> DatabaseConfig::getClient() {
+    if (!ensureInitialized()) return nullptr;
+    return registry().defaultClient;
 }
 
 std::shared_ptr<drogon::orm::DbClient> DatabaseConfig::getClient(const std::string& name) {
-    if (!_initialized) {
-        // Auto-initialize if not already initialized
-        std::cout << "Auto-initializing database configuration..." << std::endl;
-        if (!initialize()) {
-            std::cerr << "Auto-initialization failed" << std::endl;
-            return nullptr;
+    if (!ensureInitialized()) return nullptr;
+    
+    if (const auto* entry = registry().find(name)) {
+        return entry->client;
+    }
+    
+    AsyncLog::info() << "Database client not found: " << name;
+    return nullptr;
+}
+
+std::shared_ptr<drogon::orm::DbClient> DatabaseConfig::getReadClient() {
+    if (!ensureInitialized()) return nullptr;
+    
+    const auto& current = registry();
+    size_t count = current.replicas.size();
+    if (count > 0) {
+        // Prefer a usable replica with a free connection; a usable but busy one
+        // still beats sending the read to the primary
+        size_t start = _nextReplica.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<drogon::orm::DbClient> busy;
+        for (size_t i = 0; i < count; ++i) {
+            const auto& replica = *current.replicas[(start + i) % count];
+            if (!replica.usable.load(std::memory_order_acquire)) continue;
+            if (replica.client->hasAvailableConnections()) return replica.client;
+            if (!busy) busy = replica.client;
         }
+        if (busy) return busy;
     }
     
-    auto it = _dbClients.find(name);
-    if (it != _dbClients.end()) {
-        return it->second;
+    return current.defaultClient;
+}
+
+std::string DatabaseConfig::getConnectionInfo() {
+    if (!ensureInitialized()) return "";
+    
+    const auto& current = registry();
+    for (const auto& entry : current.clients) {
+        if (entry.client == current.defaultClient) return entry.connInfo;
     }
+    return "";
+}
+
+bool DatabaseConfig::isReplica(const std::string& name) const {
+    const auto* entry = registry().find(name);
+    return entry && entry->replica;
+}
+
+void DatabaseConfig::reportReplicaHealth(const std::string& name, bool ok, double lagSeconds) {
+    const auto* entry = registry().find(name);
+    if (!entry || !entry->replica) return;
     
-    std::cout << "Database client not found: " << name << std::endl;
-    return nullptr;
-}
\ No newline at end of file
+    auto& replica = *entry->replica;
+    replica.lagSeconds.store(lagSeconds, std::memory_order_relaxed);
+    bool usable = ok && lagSeconds <= replica.maxLagSeconds;
+    bool wasUsable = replica.usable.exchange(usable, std::memory_order_acq_rel);
+    if (wasUsable && !usable) {
+        AsyncLog::error() << "Replica ejected: " << name
+                          << (ok ? " (lag " + std::to_string(lagSeconds) + "s)" : " (probe failed)");
+    } else if (!wasUsable && usable) {
+        AsyncLog::info() << "Replica restored: " << name;
+    }
+}
+
+std::vector<std::string> DatabaseConfig::getClientNames() const {
+    std::vector<std::string> names;
+    for (const auto& entry : registry().clients) {
+        names.push_back(entry.name);
+    }
+    return names;
+}
+
+Json::Value DatabaseConfig::getPoolStats() const {
+    const auto& current = registry();
+    Json::Value stats(Json::objectValue);
+    for (const auto& entry : current.clients) {
+        Json::Value pool;
+        pool["connections"] = static_cast<Json::UInt64>(entry.connections);
+        pool["has_available_connections"] = entry.client && entry.client->hasAvailableConnections();
+        pool["is_default"] = (entry.client == current.defaultClient);
+        pool["role"] = entry.replica ? "replica" : "primary";
+        if (entry.replica) {
+            pool["routable"] = entry.replica->usable.load(std::memory_order_relaxed);
+            pool["replica_lag_s"] = entry.replica->lagSeconds.load(std::memory_order_relaxed);
+        }
+        stats[entry.name] = pool;
+    }
+    return stats;
+}
@@ -1,53 +1,139 @@
 // DatabaseConfig.h
 #pragma once
 #include <drogon/drogon.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+// Registry of configured database clients. Clients are built once at startup
+// into an immutable snapshot; request threads read it without locks and a
+// reload publishes a whole new snapshot. Replaced snapshots are retired, not
+// freed, so queries already running on their clients can finish.
 class DatabaseConfig {
 public:
     // Singleton instance
     static DatabaseConfig& getInstance();
-    
+
     // Initialize database connection from config.json
     bool initialize();
-    
+
     // Initialize from specific config file path
     bool initialize(const std::string& configPath);
-    
+
+    // Re-read the config file and publish a fresh set of clients. Blocks while new
+    // clients connect, so call it off the IO loops. Clients whose settings did not
+    // change are carried over with their open connections; if any client fails to
+    // connect, nothing is published and the current clients stay in use.
+    bool reload();
+
+    // Free snapshots retired more than `drain` ago, closing the pools only they used
+    void releaseRetired(std::chrono::seconds drain);
+
+    // Snapshots waiting out their drain period
+    size_t retiredCount() const;
+
     // Get database client
     std::shared_ptr<drogon::orm::DbClient> getClient();
-    
+
     // Get database client by name
     std::shared_ptr<drogon::orm::DbClient> getClient(const std::string& name);
-    
+
+    // Client for read-only queries: round-robins across usable replicas and
+    // falls back to the default (primary) client when there are none
+    std::shared_ptr<drogon::orm::DbClient> getReadClient();
+
+    // True if the client was configured with "role": "replica"
+    bool isReplica(const std::string& name) const;
+
+    // Health report for a replica (from HealthMonitor). A replica that failed its
+    // probe or lags more than its max_lag_seconds is ejected until it recovers.
+    void reportReplicaHealth(const std::string& name, bool ok, double lagSeconds);
+
+    // libpq connection string of the default client, for work Drogon's client
+    // cannot do (COPY). Empty if there is no default client.
+    std::string getConnectionInfo();
+
+    // Names of all configured clients
+    std::vector<std::string> getClientNames() const;
+
+    // Per-client pool stats (configured connections, availability)
+    Json::Value getPoolStats() const;
+
     // Check if initialized
-    bool isInitialized() const { return _initialized; }
-    
+    bool isInitialized() const { return _initialized.load(std::memory_order_acquire); }
+
     // Get config file path
     std::string getConfigPath() const { return _configPath; }
-    
+
 private:
-    DatabaseConfig() = default;
+    DatabaseConfig();
     DatabaseConfig(const DatabaseConfig&) = delete;
     DatabaseConfig& operator=(const DatabaseConfig&) = delete;
-    
+
+    struct Replica {
+        std::string name;
+        std::shared_ptr<drogon::orm::DbClient> client;
+        double maxLagSeconds = 10;
+        std::atomic<bool> usable{true};
+        std::atomic<double> lagSeconds{0};
+    };
+
+    struct Entry {
+        std::string name;
+        std::shared_ptr<drogon::orm::DbClient> client;
+        size_t connections = 0;
+        std::string connInfo;
+        std::shared_ptr<Replica> replica;   // Null for primaries
+        bool reused = false;                 // Carried over by reload(), already connected
+    };
+
+    // Immutable once published
+    struct Registry {
+        std::vector<Entry> clients;          // Sorted by name
+        std::vector<std::shared_ptr<Replica>> replicas;
+        std::shared_ptr<drogon::orm::DbClient> defaultClient;
+        uint64_t generation = 0;
+        size_t failed = 0;                   // Clients that were configured but did not connect
+
+        const Entry* find(const std::string& name) const;
+    };
+
     // Find config.json in various locations
     std::string findConfigFile(const std::string& filename = "config.json");
-    
+
     // Load configuration from JSON file
-    bool loadConfigFile(const std::string& path);
-    
+    bool loadConfigFile(const std::string& path, Registry& registry);
+
     // Parse database configuration from JSON
-    bool parseDatabaseConfig(const Json::Value& dbConfig);
-    
+    bool parseDatabaseConfig(const Json::Value& dbConfig, Registry& registry);
+
     // Create database client from configuration
-    bool createDatabaseClient(const std::string& name, const Json::Value& config);
-    
+    bool createDatabaseClient(const std::string& name, const Json::Value& config, Registry& registry);
+
+    // Sort, pick the default and make the registry current
+    void publish(std::shared_ptr<Registry> registry);
+
+    // Current snapshot, cached per thread and refreshed only when the generation moves
+    const Registry& registry() const;
+
+    // Current snapshot, owned
+    std::shared_ptr<const Registry> current() const;
+
+    // Initialize on first use if main() has not done it yet
+    bool ensureInitialized();
+
     std::string _configPath;
-    std::map<std::string, std::shared_ptr<drogon::orm::DbClient>> _dbClients;
-    std::shared_ptr<drogon::orm::DbClient> _defaultClient;
-    bool _initialized = false;
-};
\ No newline at end of file
+    std::shared_ptr<const Registry> _registry;   // Accessed with std::atomic_load/store
+    std::atomic<uint64_t> _generation{0};
+    std::atomic<size_t> _nextReplica{0};
+    std::mutex _writeMutex;                      // Serializes initialize() and reload()
+    mutable std::mutex _retiredMutex;
+    std::vector<std::pair<std::chrono::steady_clock::time_point,
+                          std::shared_ptr<const Registry>>> _retired;
+    std::atomic<bool> _initialized{false};
+};
@@ -0,0 +1,127 @@
+// HashExecutor.cpp
+#include "HashExecutor.h"
+#include "AsyncLog.h"
+#include <drogon/utils/Utilities.h>
+#include <algorithm>
+
+HashExecutor& HashExecutor::getInstance() {
+    static HashExecutor instance;
+    return instance;
+}
+
+HashExecutor::~HashExecutor() {
+    stop();
+}
+
+void HashExecutor::start(size_t threads, size_t queueCapacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_workers.empty()) return;
+
+    _capacity = std::max<size_t>(1, queueCapacity);
+    _stopping = false;
+    threads = std::max<size_t>(1, threads);
+    for (size_t i = 0; i < threads; ++i) {
+        _workers.emplace_back([this]() { workerLoop(); });
+    }
+
+    AsyncLog::info() << "Hash executor: " << threads << " worker(s), queue capacity " << _capacity;
+}
+
+void HashExecutor::start(const Json::Value& config) {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    size_t capacity = 256;
+    if (config.isObject()) {
+        if (config["threads"].isUInt() && config["threads"].asUInt() > 0) threads = config["threads"].asUInt();
+        if (config["queue_capacity"].isUInt()) capacity = config["queue_capacity"].asUInt();
+    }
+    start(threads, capacity);
+}
+
+void HashExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_workers.empty()) return;
+        _stopping = true;
+    }
+    _cv.notify_all();
+    for (auto& worker : _workers) {
+        if (worker.joinable()) worker.join();
+    }
+    _workers.clear();
+}
+
+bool HashExecutor::enqueue(std::function<void()>&& job) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_workers.empty() || _stopping || _queue.size() >= _capacity) {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _queue.push_back(std::move(job));
+    }
+    _cv.notify_one();
+    return true;
+}
+
+void HashExecutor::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+            if (_queue.empty()) return; // Stopping and drained
+            job = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        // Failures of work are passed to done by submit(); this only guards the worker
+        try {
+            job();
+        } catch (const std::exception& e) {
+            AsyncLog::error() << "Hash executor callback failed: " << e.what();
+        }
+        _completed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void HashExecutor::reportFailure(const char* what) {
+    AsyncLog::error() << "Hash executor job failed: " << what;
+}
+
+size_t HashExecutor::queueDepth() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queue.size();
+}
+
+std::string HashExecutor::computeHash(const std::string& password) {
+    return drogon::utils::getSha256(password);
+}
+
+bool HashExecutor::checkHash(const std::string& password, const std::string& storedHash) {
+    std::string computed = computeHash(password);
+    if (computed.size() != storedHash.size()) return false;
+
+    unsigned char diff = 0;
+    for (size_t i = 0; i < computed.size(); ++i) {
+        diff |= static_cast<unsigned char>(computed[i] ^ storedHash[i]);
+    }
+    return diff == 0;
+}
+
+bool HashExecutor::hashPassword(trantor::EventLoop* loop, std::string password,
+                                std::function<void(std::optional<std::string>)> done) {
+    return submit<std::string>(
+        loop,
+        [password = std::move(password)]() { return computeHash(password); },
+        std::move(done));
+}
+
+bool HashExecutor::verifyPassword(trantor::EventLoop* loop, std::string password, std::string storedHash,
+                                  std::function<void(std::optional<bool>)> done) {
+    return submit<bool>(
+        loop,
+        [password = std::move(password), storedHash = std::move(storedHash)]() {
+            return checkHash(password, storedHash);
+        },
+        std::move(done));
+}
@@ -0,0 +1,100 @@
+// HashExecutor.h
+#pragma once
+#include <drogon/drogon.h>
+#include "Tracer.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool for CPU-heavy password hashing, kept off the IO loops.
+// The queue is bounded: submit() returns false when it is full so callers can shed load.
+class HashExecutor {
+public:
+    // Singleton instance
+    static HashExecutor& getInstance();
+
+    ~HashExecutor();
+
+    // Start the workers (no-op if already started)
+    void start(size_t threads, size_t queueCapacity);
+
+    // Start from a config section: { "threads": 2, "queue_capacity": 256 }
+    void start(const Json::Value& config);
+
+    // Stop accepting work, finish queued jobs and join the workers
+    void stop();
+
+    // Run work on a worker, then call done with its result on `loop`
+    // (on the worker thread if loop is null); done gets nullopt if work threw.
+    // Returns false if the queue is full.
+    // A traced caller gets "hash.queue" and "hash.work" spans, and done runs under its trace.
+    template <typename T>
+    bool submit(trantor::EventLoop* loop, std::function<T()> work, std::function<void(std::optional<T>)> done) {
+        auto trace = Tracer::current();
+        int64_t queuedUs = trace ? Tracer::nowMicros() : 0;
+        return enqueue([loop, work = std::move(work), done = std::move(done), trace, queuedUs]() {
+            if (trace) Tracer::getInstance().record(trace, "hash.queue", "hash", queuedUs, Tracer::nowMicros());
+            std::optional<T> result;
+            try {
+                Tracer::Span span(trace, "hash.work", "hash");
+                result = work();
+            } catch (const std::exception& e) {
+                reportFailure(e.what());
+            } catch (...) {
+                reportFailure("unknown exception");
+            }
+            if (loop) {
+                loop->queueInLoop([done, result = std::move(result), trace]() {
+                    Tracer::ContextScope scope(trace);
+                    done(result);
+                });
+            } else {
+                Tracer::ContextScope scope(trace);
+                done(std::move(result));
+            }
+        });
+    }
+
+    // Hash a password for storage (nullopt if hashing failed)
+    bool hashPassword(trantor::EventLoop* loop, std::string password,
+                      std::function<void(std::optional<std::string>)> done);
+
+    // Check a password against a stored hash (nullopt if the check failed)
+    bool verifyPassword(trantor::EventLoop* loop, std::string password, std::string storedHash,
+                        std::function<void(std::optional<bool>)> done);
+
+    // Password scheme: SHA256 hex digest (kept so existing hashes stay valid)
+    static std::string computeHash(const std::string& password);
+
+    // Constant-time comparison of the password's hash with the stored one
+    static bool checkHash(const std::string& password, const std::string& storedHash);
+
+    size_t queueDepth() const;
+    uint64_t completed() const { return _completed.load(std::memory_order_relaxed); }
+    uint64_t rejected() const { return _rejected.load(std::memory_order_relaxed); }
+    size_t threadCount() const { return _workers.size(); }
+
+private:
+    HashExecutor() = default;
+    HashExecutor(const HashExecutor&) = delete;
+    HashExecutor& operator=(const HashExecutor&) = delete;
+
+    bool enqueue(std::function<void()>&& job);
+    static void reportFailure(const char* what);
+    void workerLoop();
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::function<void()>> _queue;
+    std::vector<std::thread> _workers;
+    size_t _capacity = 0;
+    bool _stopping = false;
+    std::atomic<uint64_t> _completed{0};
+    std::atomic<uint64_t> _rejected{0};
+};
@@ -0,0 +1,209 @@
+// HealthMonitor.cpp
+#include "HealthMonitor.h"
+#include "AsyncLog.h"
+#include "DatabaseConfig.h"
+#include "Metrics.h"
+#include <atomic>
+
+using namespace drogon;
+using namespace drogon::orm;
+
+namespace {
+
+double millisecondsBetween(const trantor::Date& from, const trantor::Date& to) {
+    return static_cast<double>(to.microSecondsSinceEpoch() - from.microSecondsSinceEpoch()) / 1000.0;
+}
+
+// Seconds since the last replayed transaction; 0 when the replica has replayed
+// everything it received, so an idle primary does not look like lag
+const char* kReplicaLagSql =
+    "SELECT CASE WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0 "
+    "ELSE COALESCE(EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()), 0) "
+    "END::float8 AS lag";
+
+}
+
+HealthMonitor& HealthMonitor::getInstance() {
+    static HealthMonitor instance;
+    return instance;
+}
+
+void HealthMonitor::start(double intervalSeconds, double timeoutSeconds) {
+    if (_started) return;
+    _started = true;
+
+    auto probing = std::make_shared<std::atomic<bool>>(false);
+    auto tick = [this, probing, timeoutSeconds]() {
+        // Skip a tick if the previous round is still waiting on a slow DB
+        if (probing->exchange(true)) return;
+        probeAll(timeoutSeconds, [probing]() { probing->store(false); });
+    };
+
+    tick();
+    app().getLoop()->runEvery(intervalSeconds, tick);
+
+    AsyncLog::info() << "Health monitor: probing databases every " << intervalSeconds << "s";
+}
+
+void HealthMonitor::probe(const std::string& name,
+                          const std::shared_ptr<DbClient>& client,
+                          double timeoutSeconds,
+                          std::function<void()>&& done) {
+    struct ProbeState {
+        std::atomic<bool> finished{false};
+        std::function<void()> done;
+    };
+    auto state = std::make_shared<ProbeState>();
+    state->done = std::move(done);
+    auto startedAt = trantor::Date::now();
+
+    bool replica = DatabaseConfig::getInstance().isReplica(name);
+
+    // Whichever of result, error or timeout comes first records the outcome
+    auto finish = [this, name, state, startedAt, replica](bool ok, bool timedOut, const std::string& error,
+                                                          double lagSeconds) {
+        if (state->finished.exchange(true)) return;
+
+        ProbeResult result;
+        result.probed = true;
+        result.ok = ok;
+        result.timedOut = timedOut;
+        result.error = error;
+        result.checkedAt = trantor::Date::now();
+        result.latencyMs = millisecondsBetween(startedAt, result.checkedAt);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _results[name] = result;
+        }
+        if (replica) {
+            DatabaseConfig::getInstance().reportReplicaHealth(name, ok, lagSeconds);
+        }
+        state->done();
+    };
+
+    app().getLoop()->runAfter(timeoutSeconds, [finish]() {
+        finish(false, true, "probe timed out", 0);
+    });
+
+    auto timer = Metrics::startQuery(Metrics::kQueryHealthProbe);
+    client->execSqlAsync(
+        replica ? kReplicaLagSql : "SELECT 1",
+        [finish, timer, replica](const Result& r) {
+            timer.done(true);
+            double lag = (replica && !r.empty()) ? r[0]["lag"].as<double>() : 0;
+            finish(true, false, "", lag);
+        },
+        [finish, timer](const DrogonDbException& e) {
+            timer.done(false);
+            finish(false, false, e.base().what(), 0);
+        });
+}
+
+void HealthMonitor::probeAll(double timeoutSeconds, std::function<void()>&& done) {
+    auto& config = DatabaseConfig::getInstance();
+    auto names = config.getClientNames();
+    if (names.empty()) {
+        done();
+        return;
+    }
+
+    auto remaining = std::make_shared<std::atomic<size_t>>(names.size());
+    auto finished = std::make_shared<std::function<void()>>(std::move(done));
+    for (const auto& name : names) {
+        auto client = config.getClient(name);
+        auto onProbed = [remaining, finished]() {
+            if (remaining->fetch_sub(1) == 1) (*finished)();
+        };
+        if (!client) {
+            onProbed();
+            continue;
+        }
+        probe(name, client, timeoutSeconds, onProbed);
+    }
+}
+
+void HealthMonitor::probeNow(double timeoutSeconds, std::function<void(Json::Value)>&& done) {
+    bool reuse = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_deepProbing) {
+            _deepWaiters.push_back(std::move(done));
+            return;
+        }
+        reuse = _lastDeepProbe.microSecondsSinceEpoch() > 0 &&
+                millisecondsBetween(_lastDeepProbe, trantor::Date::now()) < kMinDeepIntervalSeconds * 1000;
+        if (!reuse) {
+            _deepProbing = true;
+            _deepWaiters.push_back(std::move(done));
+        }
+    }
+    if (reuse) {
+        done(snapshot());
+        return;
+    }
+
+    probeAll(timeoutSeconds, [this]() {
+        std::vector<std::function<void(Json::Value)>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _deepProbing = false;
+            _lastDeepProbe = trantor::Date::now();
+            waiters.swap(_deepWaiters);
+        }
+        auto json = snapshot();
+        for (auto& waiter : waiters) waiter(json);
+    });
+}
+
+bool HealthMonitor::isHealthy(const std::string& clientName) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _results.find(clientName);
+    return it != _results.end() && it->second.ok;
+}
+
+Json::Value HealthMonitor::snapshot() const {
+    Json::Value json;
+    json["status"] = "ok";
+    json["service"] = "Drogon Web Server";
+
+    auto& config = DatabaseConfig::getInstance();
+    auto pools = config.getPoolStats();
+    if (pools.empty()) {
+        json["database"] = "not_configured";
+        return json;
+    }
+    json["database"] = "configured";
+
+    auto now = trantor::Date::now();
+    bool allProbed = true;
+    bool anyFailed = false;
+    std::string firstError;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& name : pools.getMemberNames()) {
+        Json::Value db = pools[name];
+        auto it = _results.find(name);
+        if (it == _results.end() || !it->second.probed) {
+            db["status"] = "pending";
+            allProbed = false;
+        } else {
+            const auto& result = it->second;
+            db["status"] = result.ok ? "up" : (result.timedOut ? "timeout" : "down");
+            db["latency_ms"] = result.latencyMs;
+            db["age_ms"] = millisecondsBetween(result.checkedAt, now);
+            if (!result.ok) {
+                db["error"] = result.error;
+                anyFailed = true;
+                if (firstError.empty()) firstError = result.error;
+            }
+        }
+        json["databases"][name] = db;
+    }
+
+    json["database_test"] = anyFailed ? "failed" : (allProbed ? "passed" : "pending");
+    if (!firstError.empty()) {
+        json["database_error"] = firstError;
+    }
+
+    return json;
+}
@@ -0,0 +1,64 @@
+// HealthMonitor.h
+#pragma once
+#include <drogon/drogon.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Probes every database client on a background timer so /health never blocks.
+// Replica results also drive read routing in DatabaseConfig.
+class HealthMonitor {
+public:
+    // Singleton instance
+    static HealthMonitor& getInstance();
+
+    // Start periodic probing on the main event loop
+    void start(double intervalSeconds = 5.0, double timeoutSeconds = 2.0);
+
+    // Last cached probe results, pool stats and overall status
+    Json::Value snapshot() const;
+
+    // Probe every client now, then call done with a fresh snapshot.
+    // Probes that do not answer within timeoutSeconds are reported as timed out.
+    // /health is public, so this is rate limited: a round younger than
+    // kMinDeepIntervalSeconds is reused, and callers arriving while one runs
+    // share it.
+    void probeNow(double timeoutSeconds, std::function<void(Json::Value)>&& done);
+
+    static constexpr double kMinDeepIntervalSeconds = 2.0;
+
+    // True if the last probe of the client succeeded
+    bool isHealthy(const std::string& clientName) const;
+
+private:
+    HealthMonitor() = default;
+    HealthMonitor(const HealthMonitor&) = delete;
+    HealthMonitor& operator=(const HealthMonitor&) = delete;
+
+    struct ProbeResult {
+        bool probed = false;
+        bool ok = false;
+        bool timedOut = false;
+        double latencyMs = 0;
+        std::string error;
+        trantor::Date checkedAt;
+    };
+
+    // Run an async SELECT 1 (or the lag query for replicas) against one client;
+    // done is called exactly once
+    void probe(const std::string& name,
+               const std::shared_ptr<drogon::orm::DbClient>& client,
+               double timeoutSeconds,
+               std::function<void()>&& done);
+
+    void probeAll(double timeoutSeconds, std::function<void()>&& done);
+
+    mutable std::mutex _mutex;
+    std::map<std::string, ProbeResult> _results;
+    bool _deepProbing = false;
+    trantor::Date _lastDeepProbe;
+    std::vector<std::function<void(Json::Value)>> _deepWaiters;
+    bool _started = false;
+};
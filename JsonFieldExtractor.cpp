@@ -0,0 +1,278 @@
+// JsonFieldExtractor.cpp
+#include "JsonFieldExtractor.h"
+#include <algorithm>
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool readHex4(std::string_view raw, size_t pos, unsigned& value) {
+    if (pos + 4 > raw.size()) return false;
+    value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        int digit = hexValue(raw[i]);
+        if (digit < 0) return false;
+        value = (value << 4) | static_cast<unsigned>(digit);
+    }
+    return true;
+}
+
+void appendUtf8(std::string& out, unsigned codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+}
+
+JsonFieldExtractor::Limits JsonFieldExtractor::limitsFromConfig(const Json::Value& config) {
+    Limits limits;
+    if (!config.isObject()) return limits;
+    if (config["max_body_bytes"].isUInt()) limits.maxBodyBytes = config["max_body_bytes"].asUInt();
+    if (config["max_field_bytes"].isUInt()) limits.maxFieldBytes = config["max_field_bytes"].asUInt();
+    return limits;
+}
+
+JsonFieldExtractor::JsonFieldExtractor(std::initializer_list<std::string_view> keys, Limits limits)
+    : _keyCount(std::min(keys.size(), kMaxFields)), _limits(limits) {
+    std::copy_n(keys.begin(), _keyCount, _keys.begin());
+}
+
+JsonFieldExtractor::JsonFieldExtractor(std::initializer_list<std::string_view> keys)
+    : JsonFieldExtractor(keys, Limits()) {}
+
+JsonFieldExtractor::Status JsonFieldExtractor::parse(std::string_view body) {
+    _values.fill({});
+    _present.fill(false);
+    _tooLarge = false;
+    _body = body;
+    _pos = 0;
+
+    // Checked before looking at a single byte
+    if (body.size() > _limits.maxBodyBytes) return Status::kTooLarge;
+
+    skipWhitespace();
+    if (!parseObject()) return _tooLarge ? Status::kTooLarge : Status::kMalformed;
+    skipWhitespace();
+    return _pos == _body.size() ? Status::kOk : Status::kMalformed;
+}
+
+bool JsonFieldExtractor::parseObject() {
+    if (_pos >= _body.size() || _body[_pos] != '{') return false;
+    ++_pos;
+    skipWhitespace();
+    if (_pos < _body.size() && _body[_pos] == '}') {
+        ++_pos;
+        return true;
+    }
+
+    std::string decodedKey;
+    while (true) {
+        skipWhitespace();
+        std::string_view key;
+        bool escaped = false;
+        if (!parseString(key, escaped)) return false;
+        if (escaped) {
+            if (!unescape(key, decodedKey)) return false;
+            key = decodedKey;
+        }
+
+        skipWhitespace();
+        if (_pos >= _body.size() || _body[_pos] != ':') return false;
+        ++_pos;
+        skipWhitespace();
+
+        size_t index = std::find(_keys.begin(), _keys.begin() + _keyCount, key) - _keys.begin();
+        if (index < _keyCount) {
+            // Requested keys must hold strings; a repeated key overrides, as in jsoncpp
+            std::string_view raw;
+            if (_pos >= _body.size() || _body[_pos] != '"' || !parseString(raw, escaped)) return false;
+            if (raw.size() > _limits.maxFieldBytes) {
+                _tooLarge = true;
+                return false;
+            }
+            if (escaped) {
+                if (!unescape(raw, _decoded[index])) return false;
+                _values[index] = _decoded[index];
+            } else {
+                _values[index] = raw;
+            }
+            _present[index] = true;
+        } else if (!skipValue(1)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (_pos >= _body.size()) return false;
+        char c = _body[_pos++];
+        if (c == '}') return true;
+        if (c != ',') return false;
+    }
+}
+
+bool JsonFieldExtractor::parseString(std::string_view& raw, bool& escaped) {
+    if (_pos >= _body.size() || _body[_pos] != '"') return false;
+    escaped = false;
+    size_t start = _pos + 1;
+    for (size_t i = start; i < _body.size(); ++i) {
+        auto c = static_cast<unsigned char>(_body[i]);
+        if (c == '"') {
+            raw = _body.substr(start, i - start);
+            _pos = i + 1;
+            return true;
+        }
+        if (c == '\\') {
+            escaped = true;
+            ++i;
+        } else if (c < 0x20) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool JsonFieldExtractor::skipValue(size_t depth) {
+    if (depth > _limits.maxDepth || _pos >= _body.size()) return false;
+
+    std::string_view ignored;
+    bool escaped = false;
+    char open = _body[_pos];
+    if (open == '"') return parseString(ignored, escaped);
+    if (open != '{' && open != '[') return skipLiteral();
+
+    char close = open == '{' ? '}' : ']';
+    ++_pos;
+    skipWhitespace();
+    if (_pos < _body.size() && _body[_pos] == close) {
+        ++_pos;
+        return true;
+    }
+    while (true) {
+        skipWhitespace();
+        if (open == '{') {
+            if (!parseString(ignored, escaped)) return false;
+            skipWhitespace();
+            if (_pos >= _body.size() || _body[_pos] != ':') return false;
+            ++_pos;
+            skipWhitespace();
+        }
+        if (!skipValue(depth + 1)) return false;
+
+        skipWhitespace();
+        if (_pos >= _body.size()) return false;
+        char c = _body[_pos++];
+        if (c == close) return true;
+        if (c != ',') return false;
+    }
+}
+
+bool JsonFieldExtractor::skipLiteral() {
+    std::string_view rest = _body.substr(_pos);
+    for (std::string_view word : {std::string_view("true"), std::string_view("false"), std::string_view("null")}) {
+        if (rest.substr(0, word.size()) == word) {
+            _pos += word.size();
+            return atDelimiter();
+        }
+    }
+
+    // Numbers only need to be skipped, not converted, but must follow the grammar:
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    if (_pos < _body.size() && _body[_pos] == '-') ++_pos;
+    if (_pos >= _body.size() || !isDigit(_body[_pos])) return false;
+    if (_body[_pos++] != '0') skipDigits();
+    if (_pos < _body.size() && _body[_pos] == '.') {
+        ++_pos;
+        if (!skipDigits()) return false;
+    }
+    if (_pos < _body.size() && (_body[_pos] == 'e' || _body[_pos] == 'E')) {
+        ++_pos;
+        if (_pos < _body.size() && (_body[_pos] == '+' || _body[_pos] == '-')) ++_pos;
+        if (!skipDigits()) return false;
+    }
+    return atDelimiter();
+}
+
+bool JsonFieldExtractor::skipDigits() {
+    size_t start = _pos;
+    while (_pos < _body.size() && isDigit(_body[_pos])) ++_pos;
+    return _pos > start;
+}
+
+bool JsonFieldExtractor::atDelimiter() const {
+    if (_pos >= _body.size()) return true;
+    char c = _body[_pos];
+    return isWhitespace(c) || c == ',' || c == '}' || c == ']';
+}
+
+void JsonFieldExtractor::skipWhitespace() {
+    while (_pos < _body.size() && isWhitespace(_body[_pos])) ++_pos;
+}
+
+bool JsonFieldExtractor::unescape(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+        if (++i >= raw.size()) return false;
+        switch (raw[i]) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                unsigned codePoint = 0;
+                if (!readHex4(raw, i + 1, codePoint)) return false;
+                i += 4;
+                if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) return false;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    // High surrogate: the low half must follow as another \u escape
+                    unsigned low = 0;
+                    if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' ||
+                        !readHex4(raw, i + 3, low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    i += 6;
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, codePoint);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+// JsonFieldExtractor.h
+#pragma once
+#include <json/json.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Single-pass extraction of a few top-level string fields from a JSON object body,
+// for the small, hot POST endpoints (login, register) that would otherwise build a
+// jsoncpp DOM to read two or three strings.
+//
+// Values are string_views into the body, so the body must outlive the extractor.
+// Only values containing escape sequences are decoded, into storage owned by the
+// extractor. Everything that is not a requested key is skipped without copying.
+//
+//   JsonFieldExtractor fields({"username", "password"}, limits);
+//   if (fields.parse(req->body()) == JsonFieldExtractor::Status::kOk && fields.has(0)) ...
+class JsonFieldExtractor {
+public:
+    static constexpr size_t kMaxFields = 4;
+
+    enum class Status {
+        kOk,
+        kTooLarge,      // Body or a requested value over the limits
+        kMalformed      // Not a JSON object, or a requested key holds a non-string
+    };
+
+    struct Limits {
+        size_t maxBodyBytes = 4096;
+        size_t maxFieldBytes = 1024;    // Raw (still escaped) size of one requested value
+        size_t maxDepth = 8;            // Nesting allowed in skipped values
+    };
+
+    // Limits from a config section: { "max_body_bytes": 4096, "max_field_bytes": 1024 }
+    static Limits limitsFromConfig(const Json::Value& config);
+
+    // Keys to extract (at most kMaxFields); values are addressed by their index here
+    JsonFieldExtractor(std::initializer_list<std::string_view> keys, Limits limits);
+    explicit JsonFieldExtractor(std::initializer_list<std::string_view> keys);
+
+    Status parse(std::string_view body);
+
+    // After a kOk parse: whether key i was present, and its (unescaped) value
+    bool has(size_t i) const { return _present[i]; }
+    std::string_view get(size_t i) const { return _values[i]; }
+
+    // After a kOk parse: whether every requested key was present
+    bool hasAll() const {
+        return std::all_of(_present.begin(), _present.begin() + _keyCount, [](bool p) { return p; });
+    }
+
+private:
+    bool parseObject();
+    bool parseString(std::string_view& raw, bool& escaped);
+    bool skipValue(size_t depth);
+    bool skipLiteral();
+    bool skipDigits();
+    // Whether a scalar may end here: whitespace, ',', '}', ']' or the end of the body
+    bool atDelimiter() const;
+    void skipWhitespace();
+
+    // Decode the escapes of a raw string body into out; false on a bad escape
+    static bool unescape(std::string_view raw, std::string& out);
+
+    std::array<std::string_view, kMaxFields> _keys{};
+    size_t _keyCount = 0;
+    Limits _limits;
+
+    std::array<std::string_view, kMaxFields> _values{};
+    std::array<bool, kMaxFields> _present{};
+    std::array<std::string, kMaxFields> _decoded;   // Only used for escaped values
+
+    std::string_view _body;
+    size_t _pos = 0;
+    bool _tooLarge = false;
+};
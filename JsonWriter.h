@@ -0,0 +1,153 @@
+// JsonWriter.h
+#pragma once
+#include <drogon/drogon.h>
+#include "Tracer.h"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Direct-to-string JSON serialization for fixed response shapes.
+// A type opts in by specializing JsonSchema<T> with a constexpr tuple of fields;
+// writing walks that tuple at compile time, with no Json::Value tree in between.
+//
+//   template <> struct JsonSchema<User> {
+//       static constexpr auto fields = std::make_tuple(
+//           jsonField("id", &User::getId), jsonField("username", &User::getUsername));
+//   };
+template <typename T>
+struct JsonSchema;
+
+template <typename Accessor>
+struct JsonField {
+    std::string_view name;      // Written verbatim: must not need escaping
+    Accessor accessor;          // Data member or const member function pointer
+};
+
+template <typename Accessor>
+constexpr JsonField<Accessor> jsonField(std::string_view name, Accessor accessor) {
+    return {name, accessor};
+}
+
+namespace json_detail {
+
+template <typename T, typename = void>
+struct HasSchema : std::false_type {};
+
+template <typename T>
+struct HasSchema<T, std::void_t<decltype(JsonSchema<T>::fields)>> : std::true_type {};
+
+inline void appendEscaped(std::string& out, std::string_view text) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // Copy the clean run in one go, then the escape
+        out.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                out.append(escape, sizeof(escape));
+            }
+        }
+    }
+    out.append(text.data() + runStart, text.size() - runStart);
+}
+
+template <typename T>
+void writeValue(std::string& out, const T& value);
+
+template <typename T>
+void writeObject(std::string& out, const T& object) {
+    out.push_back('{');
+    bool first = true;
+    std::apply(
+        [&](const auto&... field) {
+            ((out.append(first ? "\"" : ",\"", first ? 1 : 2),
+              out.append(field.name.data(), field.name.size()),
+              out.append("\":", 2),
+              writeValue(out, std::invoke(field.accessor, object)),
+              first = false),
+             ...);
+        },
+        JsonSchema<T>::fields);
+    out.push_back('}');
+}
+
+template <typename T>
+void writeValue(std::string& out, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        out += value ? "true" : "false";
+    } else if constexpr (std::is_integral_v<T>) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, static_cast<size_t>(result.ptr - digits));
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        out.push_back('"');
+        appendEscaped(out, std::string_view(value));
+        out.push_back('"');
+    } else if constexpr (std::is_pointer_v<T>) {
+        if (value) {
+            writeValue(out, *value);
+        } else {
+            out += "null";
+        }
+    } else {
+        static_assert(HasSchema<T>::value, "type needs a JsonSchema specialization");
+        writeObject(out, value);
+    }
+}
+
+// Responses of the same shape tend to be the same size; remember the largest
+// (up to kMaxBodySizeHint) seen on this thread so the body is allocated once
+constexpr size_t kMaxBodySizeHint = 64 * 1024;
+
+inline size_t& bodySizeHint() {
+    thread_local size_t hint = 256;
+    return hint;
+}
+
+}
+
+// Serialize any JsonSchema type (or a plain value) onto out
+template <typename T>
+void writeJson(std::string& out, const T& value) {
+    json_detail::writeValue(out, value);
+}
+
+// Serialize into a fresh string sized from the per-thread hint
+template <typename T>
+std::string toJsonString(const T& value) {
+    auto& hint = json_detail::bodySizeHint();
+    std::string out;
+    out.reserve(hint);
+    json_detail::writeValue(out, value);
+    if (out.size() > hint) hint = std::min(out.size(), json_detail::kMaxBodySizeHint);
+    return out;
+}
+
+// JSON response whose body is moved in, not copied
+template <typename T>
+drogon::HttpResponsePtr newJsonResponse(const T& value,
+                                        drogon::HttpStatusCode status = drogon::k200OK) {
+    Tracer::Span span("serialize", "json");
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setStatusCode(status);
+    resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+    resp->setBody(toJsonString(value));
+    return resp;
+}
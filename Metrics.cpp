@@ -0,0 +1,197 @@
+// Metrics.cpp
+#include "Metrics.h"
+#include <chrono>
+#include <cstdio>
+
+using namespace drogon;
+
+namespace {
+
+constexpr const char* kRouteNames[Metrics::kRouteCount] = {
+    "/", "/login", "/health", "/metrics",
+    "/api/register", "/api/login", "/api/logout", "/api/me",
+    "/api/v1/users", "other"};
+
+constexpr const char* kQueryNames[Metrics::kQueryCount] = {
+    "register_insert", "login_lookup", "me_lookup", "health_probe", "list_users", "other"};
+
+constexpr const char* kStatusClasses[5] = {"1xx", "2xx", "3xx", "4xx", "5xx"};
+
+const std::string kStartAttribute = "metrics_start_us";
+
+void appendDouble(std::string& out, double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+int64_t Metrics::nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Metrics::QueryTimer::QueryTimer(Query query) : _query(query), _startUs(nowMicros()) {}
+
+void Metrics::QueryTimer::done(bool ok) const {
+    Metrics::getInstance().recordQuery(_query, ok, nowMicros() - _startUs);
+}
+
+Metrics::ThreadShard& Metrics::localShard() {
+    thread_local ThreadShard* shard = nullptr;
+    if (!shard) {
+        auto created = std::make_unique<ThreadShard>();
+        shard = created.get();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shards.push_back(std::move(created));
+    }
+    return *shard;
+}
+
+void Metrics::Histogram::observe(int64_t latencyUs) {
+    if (latencyUs < 0) latencyUs = 0;
+    double seconds = static_cast<double>(latencyUs) / 1e6;
+    size_t bucket = 0;
+    while (bucket < kBuckets.size() && seconds > kBuckets[bucket]) ++bucket;
+    buckets[bucket].add(1);
+    count.add(1);
+    sumUs.add(static_cast<uint64_t>(latencyUs));
+}
+
+Metrics::Route Metrics::routeForPath(std::string_view path) {
+    for (size_t i = 0; i < kRouteOther; ++i) {
+        if (path == kRouteNames[i]) return static_cast<Route>(i);
+    }
+    return kRouteOther;
+}
+
+void Metrics::recordRequest(Route route, int statusCode, int64_t latencyUs) {
+    auto& series = localShard().routes[route];
+    int statusClass = statusCode / 100 - 1;
+    if (statusClass >= 0 && statusClass < 5) {
+        series.statusClasses[statusClass].add(1);
+    }
+    series.latency.observe(latencyUs);
+}
+
+void Metrics::recordQuery(Query query, bool ok, int64_t latencyUs) {
+    auto& series = localShard().queries[query];
+    if (!ok) series.errors.add(1);
+    series.latency.observe(latencyUs);
+}
+
+void Metrics::install() {
+    if (_installed) return;
+    _installed = true;
+
+    app().registerPreRoutingAdvice([](const HttpRequestPtr& req) {
+        req->attributes()->insert(kStartAttribute, nowMicros());
+    });
+
+    app().registerPostHandlingAdvice([this](const HttpRequestPtr& req, const HttpResponsePtr& resp) {
+        const auto& attributes = req->attributes();
+        if (!attributes->find(kStartAttribute)) return;
+        auto latencyUs = nowMicros() - attributes->get<int64_t>(kStartAttribute);
+        recordRequest(routeForPath(req->path()), static_cast<int>(resp->statusCode()), latencyUs);
+    });
+}
+
+void Metrics::addCollector(std::function<void(std::string&)> collector) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _collectors.push_back(std::move(collector));
+}
+
+std::string Metrics::scrape() {
+    // Sum all shards into one snapshot
+    std::array<std::array<uint64_t, 5>, kRouteCount> statuses{};
+    std::array<std::array<uint64_t, kBuckets.size() + 1>, kRouteCount> routeBuckets{};
+    std::array<uint64_t, kRouteCount> routeSumUs{};
+    std::array<std::array<uint64_t, kBuckets.size() + 1>, kQueryCount> queryBuckets{};
+    std::array<uint64_t, kQueryCount> querySumUs{};
+    std::array<uint64_t, kQueryCount> queryErrors{};
+    std::vector<std::function<void(std::string&)>> collectors;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& shard : _shards) {
+            for (size_t r = 0; r < kRouteCount; ++r) {
+                const auto& series = shard->routes[r];
+                for (size_t s = 0; s < 5; ++s) statuses[r][s] += series.statusClasses[s].get();
+                for (size_t b = 0; b <= kBuckets.size(); ++b) routeBuckets[r][b] += series.latency.buckets[b].get();
+                routeSumUs[r] += series.latency.sumUs.get();
+            }
+            for (size_t q = 0; q < kQueryCount; ++q) {
+                const auto& series = shard->queries[q];
+                queryErrors[q] += series.errors.get();
+                for (size_t b = 0; b <= kBuckets.size(); ++b) queryBuckets[q][b] += series.latency.buckets[b].get();
+                querySumUs[q] += series.latency.sumUs.get();
+            }
+        }
+        collectors = _collectors;
+    }
+
+    std::string out;
+    out.reserve(16 * 1024);
+
+    auto appendHistogram = [&out](const std::string& metric, const std::string& labels,
+                                  const std::array<uint64_t, kBuckets.size() + 1>& buckets,
+                                  uint64_t sumUs) {
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b <= kBuckets.size(); ++b) {
+            cumulative += buckets[b];
+            out += metric + "_bucket{" + labels + ",le=\"";
+            if (b < kBuckets.size()) {
+                appendDouble(out, kBuckets[b]);
+            } else {
+                out += "+Inf";
+            }
+            out += "\"} " + std::to_string(cumulative) + "\n";
+        }
+        out += metric + "_sum{" + labels + "} ";
+        appendDouble(out, static_cast<double>(sumUs) / 1e6);
+        out += "\n" + metric + "_count{" + labels + "} " + std::to_string(cumulative) + "\n";
+    };
+
+    out += "# HELP drogonapp_http_requests_total HTTP requests by route and status class.\n";
+    out += "# TYPE drogonapp_http_requests_total counter\n";
+    for (size_t r = 0; r < kRouteCount; ++r) {
+        for (size_t s = 0; s < 5; ++s) {
+            if (statuses[r][s] == 0) continue;
+            out += "drogonapp_http_requests_total{route=\"" + std::string(kRouteNames[r]) +
+                   "\",status=\"" + kStatusClasses[s] + "\"} " + std::to_string(statuses[r][s]) + "\n";
+        }
+    }
+
+    out += "# HELP drogonapp_http_request_duration_seconds Time from routing to response.\n";
+    out += "# TYPE drogonapp_http_request_duration_seconds histogram\n";
+    for (size_t r = 0; r < kRouteCount; ++r) {
+        appendHistogram("drogonapp_http_request_duration_seconds",
+                        "route=\"" + std::string(kRouteNames[r]) + "\"", routeBuckets[r], routeSumUs[r]);
+    }
+
+    out += "# HELP drogonapp_db_query_duration_seconds Time from query submit to result, including pool wait.\n";
+    out += "# TYPE drogonapp_db_query_duration_seconds histogram\n";
+    for (size_t q = 0; q < kQueryCount; ++q) {
+        appendHistogram("drogonapp_db_query_duration_seconds",
+                        "query=\"" + std::string(kQueryNames[q]) + "\"", queryBuckets[q], querySumUs[q]);
+    }
+
+    out += "# HELP drogonapp_db_query_errors_total Failed DB queries.\n";
+    out += "# TYPE drogonapp_db_query_errors_total counter\n";
+    for (size_t q = 0; q < kQueryCount; ++q) {
+        out += "drogonapp_db_query_errors_total{query=\"" + std::string(kQueryNames[q]) + "\"} " +
+               std::to_string(queryErrors[q]) + "\n";
+    }
+
+    for (const auto& collector : collectors) {
+        collector(out);
+    }
+
+    return out;
+}
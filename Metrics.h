@@ -0,0 +1,123 @@
+// Metrics.h
+#pragma once
+#include <drogon/drogon.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Request and DB query counters kept per thread and summed only when /metrics is scraped
+class Metrics {
+public:
+    // Routes with their own series; everything else is counted as "other"
+    enum Route : size_t {
+        kRouteHome,
+        kRouteLogin,
+        kRouteHealth,
+        kRouteMetrics,
+        kRouteApiRegister,
+        kRouteApiLogin,
+        kRouteApiLogout,
+        kRouteApiMe,
+        kRouteApiUsers,
+        kRouteOther,
+        kRouteCount
+    };
+
+    // Named DB queries, timed from submit to callback
+    enum Query : size_t {
+        kQueryRegisterInsert,
+        kQueryLoginLookup,
+        kQueryMeLookup,
+        kQueryHealthProbe,
+        kQueryListUsers,
+        kQueryOther,
+        kQueryCount
+    };
+
+    // Latency histogram upper bounds in seconds (+Inf is implicit)
+    static constexpr std::array<double, 13> kBuckets = {
+        0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0};
+
+    // Started when a query is submitted; call done() from its result or error callback
+    class QueryTimer {
+    public:
+        explicit QueryTimer(Query query);
+        void done(bool ok) const;
+
+    private:
+        Query _query;
+        int64_t _startUs;
+    };
+
+    // Singleton instance
+    static Metrics& getInstance();
+
+    // Register the pre-routing and post-handling advices that time every request
+    void install();
+
+    // Start timing a DB query
+    static QueryTimer startQuery(Query query) { return QueryTimer(query); }
+
+    // Record one finished request / query on the calling thread
+    void recordRequest(Route route, int statusCode, int64_t latencyUs);
+    void recordQuery(Query query, bool ok, int64_t latencyUs);
+
+    // Map a request path to its route series
+    static Route routeForPath(std::string_view path);
+
+    // Extra exposition lines appended at scrape time (caches, limiters, ...)
+    void addCollector(std::function<void(std::string&)> collector);
+
+    // Prometheus text exposition of every counter
+    std::string scrape();
+
+    static int64_t nowMicros();
+
+private:
+    Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    // Single-writer counter: only the owning thread increments, scrape only reads
+    struct Counter {
+        std::atomic<uint64_t> value{0};
+        void add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    struct Histogram {
+        std::array<Counter, kBuckets.size() + 1> buckets;
+        Counter count;
+        Counter sumUs;
+        void observe(int64_t latencyUs);
+    };
+
+    struct RouteSeries {
+        std::array<Counter, 5> statusClasses; // 1xx .. 5xx
+        Histogram latency;
+    };
+
+    struct QuerySeries {
+        Counter errors;
+        Histogram latency;
+    };
+
+    struct ThreadShard {
+        std::array<RouteSeries, kRouteCount> routes;
+        std::array<QuerySeries, kQueryCount> queries;
+    };
+
+    // Shard of the calling thread, created and registered on first use
+    ThreadShard& localShard();
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadShard>> _shards;
+    std::vector<std::function<void(std::string&)>> _collectors;
+    bool _installed = false;
+};
@@ -0,0 +1,204 @@
+// RegisterBatcher.cpp
+#include "RegisterBatcher.h"
+#include "AsyncLog.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+using namespace drogon::orm;
+
+RegisterBatcher& RegisterBatcher::getInstance() {
+    static RegisterBatcher instance;
+    return instance;
+}
+
+void RegisterBatcher::start(const Json::Value& config, ClientProvider clients) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _clients = std::move(clients);
+    if (config.isObject()) {
+        _enabled = config.get("enabled", true).asBool();
+        if (config["max_batch"].isUInt()) {
+            _maxBatch = std::clamp<size_t>(config["max_batch"].asUInt(), 1, 1000);
+        }
+        if (config["window_ms"].isNumeric()) {
+            _windowSeconds = std::max(0.0, config["window_ms"].asDouble()) / 1000.0;
+        }
+    }
+
+    auto sqlBySize = std::make_shared<std::vector<std::string>>(1);
+    for (size_t rows = 1; rows <= _maxBatch; ++rows) {
+        sqlBySize->push_back(buildSql(rows));
+    }
+    std::atomic_store(&_sqlBySize, std::shared_ptr<const std::vector<std::string>>(std::move(sqlBySize)));
+
+    if (_enabled && !_loopThread) {
+        _loopThread = std::make_unique<trantor::EventLoopThread>("register-batch");
+        _loopThread->run();
+        _loop = _loopThread->getLoop();
+    }
+
+    if (_enabled) {
+        AsyncLog::info() << "Register batcher: up to " << _maxBatch << " rows per insert, "
+                         << _windowSeconds * 1000.0 << " ms window";
+    } else {
+        AsyncLog::info() << "Register batcher: disabled";
+    }
+}
+
+void RegisterBatcher::submit(trantor::EventLoop* loop, NewUser user, std::function<void(Outcome)> done) {
+    Pending pending{std::move(user), loop, std::move(done), Tracer::current()};
+
+    bool batching = false;
+    bool flushNow = false;
+    bool armTimer = false;
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        batching = _enabled && _loop;
+        if (batching) {
+            _pending.push_back(std::move(pending));
+            generation = _generation;
+            flushNow = _pending.size() >= _maxBatch;
+            armTimer = _pending.size() == 1;
+        }
+    }
+
+    if (!batching) {
+        std::vector<Pending> single;
+        single.push_back(std::move(pending));
+        sendBatch(std::move(single));
+        return;
+    }
+
+    if (flushNow) {
+        _loop->queueInLoop([this, generation]() { flush(generation); });
+    } else if (armTimer) {
+        _loop->runAfter(_windowSeconds, [this, generation]() { flush(generation); });
+    }
+}
+
+void RegisterBatcher::flush(uint64_t generation) {
+    std::vector<Pending> taken;
+    size_t maxBatch = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (generation != _generation || _pending.empty()) return;
+        ++_generation;
+        taken.swap(_pending);
+        maxBatch = _maxBatch;
+    }
+
+    // Submits racing a full-batch flush can overshoot max_batch slightly
+    while (!taken.empty()) {
+        size_t count = std::min(taken.size(), maxBatch);
+        std::vector<Pending> batch(std::make_move_iterator(taken.begin()),
+                                   std::make_move_iterator(taken.begin() + count));
+        taken.erase(taken.begin(), taken.begin() + count);
+        sendBatch(std::move(batch));
+    }
+}
+
+std::string RegisterBatcher::buildSql(size_t rows) {
+    std::string sql = "INSERT INTO users (username, email, password_hash) VALUES ";
+    for (size_t i = 0; i < rows; ++i) {
+        size_t param = i * 3;
+        if (i > 0) sql += ", ";
+        sql += "($" + std::to_string(param + 1) + ", $" + std::to_string(param + 2) +
+               ", $" + std::to_string(param + 3) + ")";
+    }
+    sql += " ON CONFLICT DO NOTHING RETURNING id, username, email";
+    return sql;
+}
+
+void RegisterBatcher::deliver(Pending& pending, Outcome outcome) {
+    if (pending.loop) {
+        pending.loop->queueInLoop(
+            [done = std::move(pending.done), outcome = std::move(outcome), trace = pending.trace]() {
+                Tracer::ContextScope scope(trace);
+                done(outcome);
+            });
+    } else {
+        Tracer::ContextScope scope(pending.trace);
+        pending.done(std::move(outcome));
+    }
+}
+
+void RegisterBatcher::sendBatch(std::vector<Pending> batch) {
+    auto client = _clients ? _clients() : nullptr;
+    if (!client) {
+        for (auto& pending : batch) {
+            deliver(pending, {Status::kError, 0, "Database not available"});
+        }
+        return;
+    }
+
+    _batches.fetch_add(1, std::memory_order_relaxed);
+    _rows.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    auto rows = std::make_shared<std::vector<Pending>>(std::move(batch));
+    // A batch cut before a reconfigure that lowered max_batch may be past the table's end
+    auto sqlBySize = std::atomic_load(&_sqlBySize);
+    auto binder = sqlBySize && rows->size() < sqlBySize->size() ? *client << (*sqlBySize)[rows->size()]
+                                                                 : *client << buildSql(rows->size());
+    for (const auto& pending : *rows) {
+        binder << pending.user.username << pending.user.email << pending.user.passwordHash;
+    }
+
+    auto timer = Metrics::startQuery(Metrics::kQueryRegisterInsert);
+    // Every traced caller gets the shared insert as a span of its own trace
+    bool traced = std::any_of(rows->begin(), rows->end(), [](const Pending& p) { return p.trace != 0; });
+    int64_t submittedUs = traced ? Tracer::nowMicros() : 0;
+    auto finish = [rows, submittedUs]() {
+        if (!submittedUs) return;
+        int64_t now = Tracer::nowMicros();
+        std::string label = "register_insert_batch (" + std::to_string(rows->size()) + " rows)";
+        for (const auto& pending : *rows) {
+            Tracer::getInstance().record(pending.trace, "register_insert_batch", "db", submittedUs, now, label);
+        }
+    };
+    binder >> [this, rows, timer, finish](const Result& r) {
+        timer.done(true);
+        finish();
+
+        // Callers with the same (username, email) are matched in submission order
+        std::unordered_map<std::string, std::deque<size_t>> waiting;
+        for (size_t i = 0; i < rows->size(); ++i) {
+            const auto& user = (*rows)[i].user;
+            waiting[user.username + '\0' + user.email].push_back(i);
+        }
+
+        std::vector<bool> created(rows->size(), false);
+        for (const auto& row : r) {
+            auto it = waiting.find(row["username"].as<std::string>() + '\0' + row["email"].as<std::string>());
+            if (it == waiting.end() || it->second.empty()) continue;
+            size_t index = it->second.front();
+            it->second.pop_front();
+            created[index] = true;
+            deliver((*rows)[index], {Status::kCreated, row["id"].as<int>(), ""});
+        }
+
+        // Everything the database skipped hit a unique username or email
+        for (size_t i = 0; i < rows->size(); ++i) {
+            if (created[i]) continue;
+            _conflicts.fetch_add(1, std::memory_order_relaxed);
+            deliver((*rows)[i], {Status::kConflict, 0, ""});
+        }
+    };
+    binder >> [this, rows, timer, finish](const DrogonDbException& e) {
+        timer.done(false);
+        finish();
+
+        // One bad row (e.g. an over-long name) must not fail its neighbours: resend singly
+        if (rows->size() > 1) {
+            for (auto& pending : *rows) {
+                std::vector<Pending> single;
+                single.push_back(std::move(pending));
+                sendBatch(std::move(single));
+            }
+            return;
+        }
+        deliver(rows->front(), {Status::kError, 0, e.base().what()});
+    };
+    binder.exec();
+}
@@ -0,0 +1,92 @@
+// RegisterBatcher.h
+#pragma once
+#include <drogon/drogon.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include "Tracer.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Coalesces concurrent /api/register inserts into one multi-row
+// INSERT ... ON CONFLICT DO NOTHING RETURNING, sent when the batch is full or the
+// window closes. Rows the database skipped are reported to their own caller as conflicts.
+class RegisterBatcher {
+public:
+    struct NewUser {
+        std::string username;
+        std::string email;
+        std::string passwordHash;
+    };
+
+    enum class Status { kCreated, kConflict, kError };
+
+    struct Outcome {
+        Status status = Status::kError;
+        int id = 0;
+        std::string error;
+    };
+
+    using ClientProvider = std::function<std::shared_ptr<drogon::orm::DbClient>()>;
+
+    // Singleton instance
+    static RegisterBatcher& getInstance();
+
+    // Configure and start the flush thread:
+    //   { "enabled": true, "max_batch": 64, "window_ms": 2 }
+    // When disabled every insert is sent on its own. May be called again to reconfigure.
+    void start(const Json::Value& config, ClientProvider clients);
+
+    // Queue one insert; done runs on `loop` (on the DB thread if loop is null) under
+    // the caller's trace, which also gets a span for the batch insert
+    void submit(trantor::EventLoop* loop, NewUser user, std::function<void(Outcome)> done);
+
+    uint64_t batches() const { return _batches.load(std::memory_order_relaxed); }
+    uint64_t rows() const { return _rows.load(std::memory_order_relaxed); }
+    uint64_t conflicts() const { return _conflicts.load(std::memory_order_relaxed); }
+
+private:
+    RegisterBatcher() = default;
+    RegisterBatcher(const RegisterBatcher&) = delete;
+    RegisterBatcher& operator=(const RegisterBatcher&) = delete;
+
+    struct Pending {
+        NewUser user;
+        trantor::EventLoop* loop = nullptr;
+        std::function<void(Outcome)> done;
+        Tracer::TraceId trace = 0;
+    };
+
+    // Send whatever is pending if the window that armed this flush is still open
+    void flush(uint64_t generation);
+
+    void sendBatch(std::vector<Pending> batch);
+
+    static void deliver(Pending& pending, Outcome outcome);
+
+    // INSERT for a batch of `rows` users
+    static std::string buildSql(size_t rows);
+
+    std::unique_ptr<trantor::EventLoopThread> _loopThread;
+    trantor::EventLoop* _loop = nullptr;
+    ClientProvider _clients;
+
+    std::mutex _mutex;
+    std::vector<Pending> _pending;
+    uint64_t _generation = 0;      // Bumped by every flush so stale window timers do nothing
+    size_t _maxBatch = 64;
+    double _windowSeconds = 0.002;
+    bool _enabled = false;
+
+    // One canonical SQL text per batch size, so each size is prepared once per connection.
+    // start() swaps in a new table; batches in flight keep the one they loaded.
+    std::shared_ptr<const std::vector<std::string>> _sqlBySize;
+
+    std::atomic<uint64_t> _batches{0};
+    std::atomic<uint64_t> _rows{0};
+    std::atomic<uint64_t> _conflicts{0};
+};
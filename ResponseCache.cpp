@@ -0,0 +1,199 @@
+// ResponseCache.cpp
+#include "ResponseCache.h"
+#include "AsyncLog.h"
+#include <drogon/utils/Utilities.h>
+
+using namespace drogon;
+
+namespace {
+
+bool compressible(ContentType type) {
+    switch (type) {
+        case CT_TEXT_HTML:
+        case CT_TEXT_PLAIN:
+        case CT_TEXT_CSS:
+        case CT_TEXT_JAVASCRIPT:
+        case CT_TEXT_XML:
+        case CT_APPLICATION_JSON:
+        case CT_APPLICATION_X_JAVASCRIPT:
+        case CT_APPLICATION_XML:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}
+
+ResponseCache& ResponseCache::getInstance() {
+    static ResponseCache instance;
+    return instance;
+}
+
+void ResponseCache::configure(const Json::Value& config) {
+    _policies.clear();
+    _enabled = false;
+    if (!config.isObject()) return;
+
+    _enabled = config.get("enabled", true).asBool();
+    _maxEntries = config.get("max_entries", 1024).asUInt();
+    _minCompressBytes = config.get("min_compress_bytes", 256).asUInt();
+
+    const auto& routes = config["routes"];
+    for (const auto& route : routes.getMemberNames()) {
+        const auto& settings = routes[route];
+        Policy policy;
+        policy.ttl = std::chrono::milliseconds(std::max(0, settings.get("ttl_ms", 1000).asInt()));
+        policy.stale = std::chrono::milliseconds(std::max(0, settings.get("stale_ms", 0).asInt()));
+        _policies[route] = policy;
+    }
+
+    AsyncLog::info() << "Response cache: " << (_enabled ? "enabled" : "disabled") << ", "
+                     << _policies.size() << " route(s)";
+}
+
+void ResponseCache::serve(const HttpRequestPtr& req,
+                          const std::string& route,
+                          std::string_view varyKey,
+                          const Builder& build,
+                          Callback&& callback) {
+    auto policy = _policies.find(route);
+    std::shared_ptr<Entry> entry;
+    if (_enabled && policy != _policies.end()) {
+        std::string key = route;
+        if (!varyKey.empty()) {
+            key += '\n';
+            key += varyKey;
+        }
+        entry = findEntry(key);
+    }
+    if (!entry) {
+        // Not cached: build for this request alone
+        build([callback = std::move(callback)](Content content) { callback(makeResponse(content)); });
+        return;
+    }
+
+    auto accepts = StaticAssets::parseAcceptEncoding(req->getHeader("accept-encoding"));
+
+    std::shared_ptr<const Snapshot> snapshot;
+    bool rebuild = false;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (entry->snapshot) {
+            auto age = Clock::now() - entry->snapshot->builtAt;
+            if (age < policy->second.ttl) {
+                snapshot = entry->snapshot;
+                _hits.fetch_add(1, std::memory_order_relaxed);
+            } else if (age < policy->second.ttl + policy->second.stale) {
+                // Serve what we have; the first stale hit starts the refresh
+                snapshot = entry->snapshot;
+                rebuild = !entry->building;
+                entry->building = true;
+                _staleHits.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (!snapshot) {
+            _misses.fetch_add(1, std::memory_order_relaxed);
+            entry->waiters.push_back({accepts, std::move(callback)});
+            if (entry->building) {
+                _coalesced.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            entry->building = true;
+            rebuild = true;
+        }
+    }
+
+    if (snapshot) callback(respond(*snapshot, accepts));
+    if (rebuild) startBuild(entry, build);
+}
+
+std::shared_ptr<ResponseCache::Entry> ResponseCache::findEntry(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(key);
+    if (it != _entries.end()) return it->second;
+    // Bounded: a vary key taken from the request must not grow the cache without limit
+    if (_entries.size() >= _maxEntries) return nullptr;
+    auto entry = std::make_shared<Entry>();
+    _entries.emplace(key, entry);
+    return entry;
+}
+
+void ResponseCache::startBuild(const std::shared_ptr<Entry>& entry, const Builder& build) {
+    _builds.fetch_add(1, std::memory_order_relaxed);
+    build([this, entry](Content content) { finishBuild(entry, std::move(content)); });
+}
+
+void ResponseCache::finishBuild(const std::shared_ptr<Entry>& entry, Content content) {
+    // Compression happens here, once per build, outside the entry lock
+    std::shared_ptr<const Snapshot> snapshot;
+    if (content.status == k200OK) snapshot = makeSnapshot(content);
+
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        // A failed refresh keeps the previous responses for the rest of their stale window
+        if (snapshot) entry->snapshot = snapshot;
+        entry->building = false;
+        waiters.swap(entry->waiters);
+    }
+
+    // A response per waiter: drogon must not send one response on several connections
+    for (auto& waiter : waiters) {
+        waiter.callback(snapshot ? respond(*snapshot, waiter.accepts) : makeResponse(content));
+    }
+}
+
+std::shared_ptr<const ResponseCache::Snapshot> ResponseCache::makeSnapshot(const Content& content) const {
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->status = content.status;
+    snapshot->contentType = content.contentType;
+    snapshot->builtAt = Clock::now();
+
+    std::string compressed[kEncodingCount];
+    if (content.body.size() >= _minCompressBytes && compressible(content.contentType)) {
+        compressed[kGzip] = utils::gzipCompress(content.body.data(), content.body.size());
+        compressed[kBrotli] = utils::brotliCompress(content.body.data(), content.body.size());
+    }
+
+    for (size_t encoding = 0; encoding < kEncodingCount; ++encoding) {
+        bool identity = encoding == kIdentity;
+        // Only kept when smaller; otherwise those clients get identity
+        if (!identity && (compressed[encoding].empty() || compressed[encoding].size() >= content.body.size())) {
+            continue;
+        }
+
+        snapshot->bodies[encoding] = identity ? content.body : std::move(compressed[encoding]);
+        snapshot->present[encoding] = true;
+    }
+    return snapshot;
+}
+
+HttpResponsePtr ResponseCache::makeResponse(const Content& content) {
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setStatusCode(content.status);
+    resp->setContentTypeCode(content.contentType);
+    resp->setBody(content.body);
+    return resp;
+}
+
+HttpResponsePtr ResponseCache::respond(const Snapshot& snapshot,
+                                       StaticAssets::AcceptedEncodings accepts) {
+    static const char* const kContentEncoding[kEncodingCount] = {nullptr, "gzip", "br"};
+    Encoding encoding = kIdentity;
+    if (accepts.brotli && snapshot.present[kBrotli]) encoding = kBrotli;
+    else if (accepts.gzip && snapshot.present[kGzip]) encoding = kGzip;
+
+    auto resp = HttpResponse::newHttpResponse();
+    resp->setStatusCode(snapshot.status);
+    resp->setContentTypeCode(snapshot.contentType);
+    resp->setBody(snapshot.bodies[encoding]);
+    resp->addHeader("Vary", "Accept-Encoding");
+    if (encoding != kIdentity) resp->addHeader("Content-Encoding", kContentEncoding[encoding]);
+    return resp;
+}
+
+size_t ResponseCache::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
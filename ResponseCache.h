@@ -0,0 +1,123 @@
+// ResponseCache.h
+#pragma once
+#include <drogon/drogon.h>
+#include "StaticAssets.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Micro-cache for GET routes whose body is the same for every anonymous client
+// ("/", "/login", "/api/v1/info"). An entry is keyed by route and an optional
+// vary key, and holds the body compressed once for identity, gzip and brotli;
+// each request gets a response around the variant its Accept-Encoding allows.
+//
+// Fresh for ttl_ms. For stale_ms after that the old bodies are still served
+// while one background build replaces them. Concurrent misses on an entry wait
+// for a single build instead of each building their own.
+class ResponseCache {
+public:
+    // What a builder produces; only k200OK content is cached
+    struct Content {
+        drogon::HttpStatusCode status = drogon::k200OK;
+        drogon::ContentType contentType = drogon::CT_TEXT_HTML;
+        std::string body;
+    };
+
+    using Callback = std::function<void(const drogon::HttpResponsePtr&)>;
+
+    // Produce an entry's content and pass it to done exactly once, from any thread
+    using Builder = std::function<void(std::function<void(Content)> done)>;
+
+    // Singleton instance
+    static ResponseCache& getInstance();
+
+    // Configure from a config section:
+    //   { "enabled": true, "max_entries": 1024, "min_compress_bytes": 256,
+    //     "routes": { "/": { "ttl_ms": 1000, "stale_ms": 30000 } } }
+    // Routes that are not listed are built on every request.
+    void configure(const Json::Value& config);
+
+    // Answer req for `route` from the cache, running build on a miss or refresh
+    void serve(const drogon::HttpRequestPtr& req,
+               const std::string& route,
+               std::string_view varyKey,
+               const Builder& build,
+               Callback&& callback);
+
+    uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+    uint64_t staleHits() const { return _staleHits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+    uint64_t coalesced() const { return _coalesced.load(std::memory_order_relaxed); }
+    uint64_t builds() const { return _builds.load(std::memory_order_relaxed); }
+    size_t size() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum Encoding : size_t { kIdentity, kGzip, kBrotli, kEncodingCount };
+
+    struct Policy {
+        Clock::duration ttl;
+        Clock::duration stale;
+    };
+
+    // One build's bodies; immutable once published and shared by every IO thread,
+    // so each hit gets a response of its own
+    struct Snapshot {
+        drogon::HttpStatusCode status = drogon::k200OK;
+        drogon::ContentType contentType = drogon::CT_TEXT_HTML;
+        std::array<std::string, kEncodingCount> bodies;
+        std::array<bool, kEncodingCount> present{};     // False when not worth compressing
+        Clock::time_point builtAt;
+    };
+
+    struct Waiter {
+        StaticAssets::AcceptedEncodings accepts;
+        Callback callback;
+    };
+
+    struct Entry {
+        std::mutex mutex;
+        std::shared_ptr<const Snapshot> snapshot;
+        bool building = false;
+        std::vector<Waiter> waiters;    // Misses waiting on the running build
+    };
+
+    ResponseCache() = default;
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // Entry for a key, created on first use; null once max_entries is reached
+    std::shared_ptr<Entry> findEntry(const std::string& key);
+
+    void startBuild(const std::shared_ptr<Entry>& entry, const Builder& build);
+    void finishBuild(const std::shared_ptr<Entry>& entry, Content content);
+
+    std::shared_ptr<const Snapshot> makeSnapshot(const Content& content) const;
+    static drogon::HttpResponsePtr makeResponse(const Content& content);
+    // Response for the best variant the client accepts
+    static drogon::HttpResponsePtr respond(const Snapshot& snapshot,
+                                           StaticAssets::AcceptedEncodings accepts);
+
+    bool _enabled = false;
+    size_t _maxEntries = 1024;
+    size_t _minCompressBytes = 256;
+    std::unordered_map<std::string, Policy> _policies;     // By route; fixed after configure()
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> _entries;
+
+    std::atomic<uint64_t> _hits{0};
+    std::atomic<uint64_t> _staleHits{0};
+    std::atomic<uint64_t> _misses{0};
+    std::atomic<uint64_t> _coalesced{0};
+    std::atomic<uint64_t> _builds{0};
+};
@@ -0,0 +1,132 @@
+// SessionStore.cpp
+#include "SessionStore.h"
+#include "AsyncLog.h"
+#include "ShardedSessionBackend.h"
+#include <drogon/utils/Utilities.h>
+#include <algorithm>
+#include <random>
+
+using namespace drogon;
+
+namespace {
+
+constexpr size_t kDefaultShards = 64;
+constexpr int kDefaultIdleTimeoutSeconds = 1800;
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}
+
+SessionId SessionId::generate() {
+    SessionId id;
+    if (!utils::secureRandomBytes(&id, sizeof(id))) {
+        // Only if the OS generator is unavailable
+        thread_local std::mt19937_64 fallback(std::random_device{}());
+        id.hi = fallback();
+        id.lo = fallback();
+    }
+    return id;
+}
+
+bool SessionId::parse(std::string_view text, SessionId& id) {
+    if (text.size() != 32) return false;
+    uint64_t words[2] = {0, 0};
+    for (size_t i = 0; i < 32; ++i) {
+        int digit = hexDigit(text[i]);
+        if (digit < 0) return false;
+        words[i / 16] = (words[i / 16] << 4) | static_cast<uint64_t>(digit);
+    }
+    id.hi = words[0];
+    id.lo = words[1];
+    return true;
+}
+
+std::string SessionId::toString() const {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (size_t i = 0; i < 16; ++i) {
+        text[15 - i] = kHex[(hi >> (4 * i)) & 0xF];
+        text[31 - i] = kHex[(lo >> (4 * i)) & 0xF];
+    }
+    return text;
+}
+
+void SessionData::setUsername(std::string_view username) {
+    _usernameLength = static_cast<uint8_t>(std::min(username.size(), kMaxUsername));
+    std::copy_n(username.data(), _usernameLength, _username.begin());
+}
+
+SessionStore& SessionStore::getInstance() {
+    static SessionStore instance;
+    return instance;
+}
+
+SessionStore::SessionStore()
+    : _backend(std::make_unique<ShardedSessionBackend>(
+          kDefaultShards, std::chrono::seconds(kDefaultIdleTimeoutSeconds))) {}
+
+void SessionStore::configure(const Json::Value& config) {
+    if (!config.isObject()) return;
+
+    _cookieName = config.get("cookie_name", _cookieName).asString();
+    _secureCookie = config.get("secure_cookie", _secureCookie).asBool();
+
+    std::string backend = config.get("backend", "sharded").asString();
+    if (backend != "sharded") {
+        AsyncLog::error() << "Session store: unknown backend '" << backend << "', using sharded";
+    }
+    size_t shards = config.get("shards", static_cast<Json::UInt>(kDefaultShards)).asUInt();
+    int idleTimeout = config.get("idle_timeout_seconds", kDefaultIdleTimeoutSeconds).asInt();
+    auto sharded = std::make_unique<ShardedSessionBackend>(std::max<size_t>(1, shards),
+                                                           std::chrono::seconds(idleTimeout));
+    AsyncLog::info() << "Session store: " << sharded->shardCount() << " shards, idle timeout "
+                     << idleTimeout << " s";
+    _backend = std::move(sharded);
+}
+
+void SessionStore::setBackend(std::unique_ptr<SessionBackend> backend) {
+    if (backend) _backend = std::move(backend);
+}
+
+std::optional<SessionData> SessionStore::find(const HttpRequestPtr& req) {
+    SessionId id;
+    if (!SessionId::parse(req->getCookie(_cookieName), id)) return std::nullopt;
+
+    SessionData data;
+    if (!_backend->get(id, data)) return std::nullopt;
+    return data;
+}
+
+void SessionStore::start(const HttpRequestPtr& req, const HttpResponsePtr& resp,
+                         const SessionData& data) {
+    // A new id on every login, so an id planted before login is worthless after it
+    SessionId old;
+    if (SessionId::parse(req->getCookie(_cookieName), old)) _backend->erase(old);
+
+    auto id = SessionId::generate();
+    _backend->put(id, data);
+    resp->addCookie(makeCookie(id.toString()));
+}
+
+void SessionStore::end(const HttpRequestPtr& req, const HttpResponsePtr& resp) {
+    SessionId id;
+    if (SessionId::parse(req->getCookie(_cookieName), id)) _backend->erase(id);
+
+    auto cookie = makeCookie("");
+    cookie.setMaxAge(0);
+    resp->addCookie(cookie);
+}
+
+Cookie SessionStore::makeCookie(const std::string& value) const {
+    Cookie cookie(_cookieName, value);
+    cookie.setPath("/");
+    cookie.setHttpOnly(true);
+    cookie.setSecure(_secureCookie);
+    cookie.setSameSite(Cookie::SameSite::kLax);
+    return cookie;
+}
@@ -0,0 +1,104 @@
+// SessionStore.h
+#pragma once
+#include <drogon/drogon.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// 128-bit random session id, sent to the client as 32 hex characters
+struct SessionId {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    // New id from the system CSPRNG
+    static SessionId generate();
+
+    // Parse the cookie form; false for anything that is not 32 hex characters
+    static bool parse(std::string_view text, SessionId& id);
+
+    std::string toString() const;
+
+    bool operator==(const SessionId& other) const { return hi == other.hi && lo == other.lo; }
+};
+
+// What a session carries, stored inline (no per-session heap allocation)
+struct SessionData {
+    static constexpr size_t kMaxUsername = 50;     // users.username column
+
+    int userId = 0;
+
+    std::string_view username() const { return {_username.data(), _usernameLength}; }
+    void setUsername(std::string_view username);
+
+private:
+    uint8_t _usernameLength = 0;
+    std::array<char, kMaxUsername> _username{};
+};
+
+// Where sessions live. Implementations must be thread-safe: every IO loop calls
+// get() concurrently, and tick() runs on the main loop.
+class SessionBackend {
+public:
+    virtual ~SessionBackend() = default;
+
+    // Store or replace a session; it expires after the backend's idle timeout
+    virtual void put(const SessionId& id, const SessionData& data) = 0;
+
+    // Copy a live session into out and extend its lifetime; false if missing or expired
+    virtual bool get(const SessionId& id, SessionData& out) = 0;
+
+    virtual void erase(const SessionId& id) = 0;
+
+    // Drop expired sessions; called about once a second
+    virtual void tick() = 0;
+
+    virtual size_t size() const = 0;
+    virtual uint64_t expiredCount() const = 0;
+};
+
+// Cookie-based sessions for the auth endpoints and AuthFilter, in place of
+// drogon's built-in session map ("enable_session": false in config.json)
+class SessionStore {
+public:
+    // Singleton instance
+    static SessionStore& getInstance();
+
+    // Configure from a config section:
+    //   { "backend": "sharded", "shards": 64, "idle_timeout_seconds": 1800,
+    //     "cookie_name": "sid", "secure_cookie": false }
+    // Call before the server starts; the backend is not swapped under load.
+    void configure(const Json::Value& config);
+
+    // Replace the backend (e.g. an external store); same rule as configure()
+    void setBackend(std::unique_ptr<SessionBackend> backend);
+
+    // Session named by the request's cookie, if it is live
+    std::optional<SessionData> find(const drogon::HttpRequestPtr& req);
+
+    // Start a session under a fresh id (dropping the request's old one) and set its cookie
+    void start(const drogon::HttpRequestPtr& req, const drogon::HttpResponsePtr& resp,
+               const SessionData& data);
+
+    // Drop the request's session and clear its cookie
+    void end(const drogon::HttpRequestPtr& req, const drogon::HttpResponsePtr& resp);
+
+    void tick() { _backend->tick(); }
+
+    SessionBackend& backend() { return *_backend; }
+    size_t size() const { return _backend->size(); }
+    uint64_t expiredCount() const { return _backend->expiredCount(); }
+
+private:
+    SessionStore();
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    drogon::Cookie makeCookie(const std::string& value) const;
+
+    std::unique_ptr<SessionBackend> _backend;
+    std::string _cookieName = "sid";
+    bool _secureCookie = false;
+};
@@ -0,0 +1,204 @@
+// ShardedSessionBackend.cpp
+#include "ShardedSessionBackend.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace {
+
+constexpr unsigned kSlotBits = 6;
+constexpr uint64_t kSlots = uint64_t(1) << kSlotBits;    // Per level
+constexpr unsigned kLevels = 4;
+constexpr uint64_t kWheelSpan = uint64_t(1) << (kSlotBits * kLevels);
+constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+
+struct IdHash {
+    size_t operator()(const SessionId& id) const {
+        // Ids are random; the low word is as good a hash as any
+        return static_cast<size_t>(id.lo);
+    }
+};
+
+}
+
+struct ShardedSessionBackend::Shard {
+    struct Node {
+        SessionId id;
+        SessionData data;
+        uint64_t expiresAt = 0;     // Tick; moved forward by get() without relinking
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t slot = 0;          // level * kSlots + index
+    };
+
+    alignas(64) std::mutex mutex;
+    std::unordered_map<SessionId, uint32_t, IdHash> index;
+    std::vector<Node> nodes;        // Slab; freed nodes are reused
+    std::vector<uint32_t> freeNodes;
+    std::array<uint32_t, kLevels * kSlots> slots;
+    uint64_t currentTick = 0;
+
+    Shard() { slots.fill(kNil); }
+
+    void link(uint32_t n) {
+        auto& node = nodes[n];
+        uint64_t deadline = std::max(node.expiresAt, currentTick + 1);
+        uint64_t delta = std::min(deadline - currentTick, kWheelSpan - 1);
+        deadline = currentTick + delta;
+
+        unsigned level = 0;
+        while (level + 1 < kLevels && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) ++level;
+        node.slot = static_cast<uint32_t>(level * kSlots + ((deadline >> (kSlotBits * level)) & (kSlots - 1)));
+
+        node.prev = kNil;
+        node.next = slots[node.slot];
+        if (node.next != kNil) nodes[node.next].prev = n;
+        slots[node.slot] = n;
+    }
+
+    void unlink(uint32_t n) {
+        auto& node = nodes[n];
+        if (node.prev != kNil) nodes[node.prev].next = node.next;
+        else slots[node.slot] = node.next;
+        if (node.next != kNil) nodes[node.next].prev = node.prev;
+    }
+
+    uint32_t allocate() {
+        if (!freeNodes.empty()) {
+            uint32_t n = freeNodes.back();
+            freeNodes.pop_back();
+            return n;
+        }
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    void release(uint32_t n) {
+        unlink(n);
+        index.erase(nodes[n].id);
+        freeNodes.push_back(n);
+    }
+
+    // Detach a slot's list and hand every node to fn
+    template <typename F>
+    void drain(uint32_t slot, F&& fn) {
+        uint32_t n = slots[slot];
+        slots[slot] = kNil;
+        while (n != kNil) {
+            uint32_t next = nodes[n].next;
+            fn(n);
+            n = next;
+        }
+    }
+
+    // Step the wheel to `target`; returns the number of sessions expired
+    size_t advance(uint64_t target) {
+        size_t expired = 0;
+        while (currentTick < target) {
+            ++currentTick;
+
+            // Higher levels first: what they release may land in a lower slot that cascades next
+            for (unsigned level = kLevels - 1; level > 0; --level) {
+                uint64_t lowBits = currentTick & ((uint64_t(1) << (kSlotBits * level)) - 1);
+                if (lowBits != 0) continue;
+                uint64_t slotIndex = (currentTick >> (kSlotBits * level)) & (kSlots - 1);
+                drain(static_cast<uint32_t>(level * kSlots + slotIndex), [this](uint32_t n) { link(n); });
+            }
+
+            drain(static_cast<uint32_t>(currentTick & (kSlots - 1)), [this, &expired](uint32_t n) {
+                if (nodes[n].expiresAt > currentTick) {
+                    link(n);            // Used since it was armed: re-arm at the new deadline
+                    return;
+                }
+                nodes[n].prev = kNil;   // Already detached from the slot
+                nodes[n].next = kNil;
+                index.erase(nodes[n].id);
+                freeNodes.push_back(n);
+                ++expired;
+            });
+        }
+        return expired;
+    }
+};
+
+ShardedSessionBackend::ShardedSessionBackend(size_t shards, std::chrono::seconds idleTimeout)
+    : _idleTimeout(static_cast<uint64_t>(std::max<std::chrono::seconds::rep>(1, idleTimeout.count()))),
+      _epoch(std::chrono::steady_clock::now()) {
+    size_t count = 1;
+    while (count < shards) count <<= 1;
+    _shards.reserve(count);
+    for (size_t i = 0; i < count; ++i) _shards.push_back(std::make_unique<Shard>());
+    _shardMask = count - 1;
+}
+
+ShardedSessionBackend::~ShardedSessionBackend() = default;
+
+uint64_t ShardedSessionBackend::now() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _epoch).count());
+}
+
+void ShardedSessionBackend::put(const SessionId& id, const SessionData& data) {
+    uint64_t expiresAt = now() + _idleTimeout;
+    auto& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(id);
+    if (it != shard.index.end()) {
+        auto& node = shard.nodes[it->second];
+        node.data = data;
+        node.expiresAt = std::max(node.expiresAt, expiresAt);
+        return;
+    }
+
+    uint32_t n = shard.allocate();
+    auto& node = shard.nodes[n];
+    node.id = id;
+    node.data = data;
+    node.expiresAt = expiresAt;
+    shard.link(n);
+    shard.index.emplace(id, n);
+    _size.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ShardedSessionBackend::get(const SessionId& id, SessionData& out) {
+    uint64_t current = now();
+    auto& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(id);
+    if (it == shard.index.end()) return false;
+
+    auto& node = shard.nodes[it->second];
+    if (node.expiresAt <= current) {
+        // Past its deadline but the wheel has not reached it yet
+        shard.release(it->second);
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        _expired.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    node.expiresAt = current + _idleTimeout;
+    out = node.data;
+    return true;
+}
+
+void ShardedSessionBackend::erase(const SessionId& id) {
+    auto& shard = shardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(id);
+    if (it == shard.index.end()) return;
+    shard.release(it->second);
+    _size.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ShardedSessionBackend::tick() {
+    uint64_t target = now();
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        size_t expired = shard->advance(target);
+        if (expired == 0) continue;
+        _size.fetch_sub(expired, std::memory_order_relaxed);
+        _expired.fetch_add(expired, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,49 @@
+// ShardedSessionBackend.h
+#pragma once
+#include "SessionStore.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// In-process SessionBackend. Sessions are spread over independently locked shards
+// by id, so concurrent lookups rarely meet on a lock, and each shard expires its
+// sessions with a hierarchical timer wheel (4 levels x 64 one-second slots, ~194 days).
+//
+// get() only moves the deadline forward; the wheel is not touched. When a session's
+// slot fires and its deadline has moved, it is re-armed in the right slot. Insert,
+// lookup, erase and expiry are all O(1), and a tick costs the same with 1M sessions
+// as with ten.
+class ShardedSessionBackend : public SessionBackend {
+public:
+    // shards is rounded up to a power of two
+    ShardedSessionBackend(size_t shards, std::chrono::seconds idleTimeout);
+    ~ShardedSessionBackend() override;
+
+    void put(const SessionId& id, const SessionData& data) override;
+    bool get(const SessionId& id, SessionData& out) override;
+    void erase(const SessionId& id) override;
+    void tick() override;
+
+    size_t size() const override { return _size.load(std::memory_order_relaxed); }
+    uint64_t expiredCount() const override { return _expired.load(std::memory_order_relaxed); }
+
+    size_t shardCount() const { return _shards.size(); }
+
+private:
+    struct Shard;
+
+    // Whole seconds since construction; the wheel's time base
+    uint64_t now() const;
+
+    Shard& shardFor(const SessionId& id) { return *_shards[(id.hi >> 32) & _shardMask]; }
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+    size_t _shardMask = 0;
+    uint64_t _idleTimeout;
+    std::chrono::steady_clock::time_point _epoch;
+    std::atomic<size_t> _size{0};
+    std::atomic<uint64_t> _expired{0};
+};
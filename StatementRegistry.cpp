@@ -0,0 +1,26 @@
+// StatementRegistry.cpp
+#include "StatementRegistry.h"
+#include <array>
+#include <cassert>
+
+namespace {
+
+// Indexed by StatementRegistry::Id
+const std::array<StatementRegistry::Statement, StatementRegistry::kCount> kStatements = {{
+    {StatementRegistry::kFindUserByLogin, "find_user_by_login",
+     "SELECT id, username, email, password_hash FROM users WHERE username = $1 OR email = $1",
+     Metrics::kQueryLoginLookup},
+    {StatementRegistry::kFindUserById, "find_user_by_id",
+     "SELECT id, username, email FROM users WHERE id = $1",
+     Metrics::kQueryMeLookup},
+    {StatementRegistry::kListUsersAfter, "list_users_after",
+     "SELECT id, username, email FROM users WHERE id > $1 ORDER BY id LIMIT $2",
+     Metrics::kQueryListUsers},
+}};
+
+}
+
+const StatementRegistry::Statement& StatementRegistry::get(Id id) {
+    assert(id < kCount && kStatements[id].id == id);
+    return kStatements[id];
+}
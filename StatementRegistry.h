@@ -0,0 +1,72 @@
+// StatementRegistry.h
+#pragma once
+#include <drogon/orm/DbClient.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include "Metrics.h"
+#include "Tracer.h"
+
+// The app's SQL, declared once by name and executed by handle.
+// Drogon prepares a parameterized statement on each connection the first time it
+// sees its text (and again after a reconnect); one canonical string per statement
+// keeps every execution on that prepared plan. Register inserts vary in row count
+// and are built by RegisterBatcher instead.
+class StatementRegistry {
+public:
+    enum Id : size_t {
+        kFindUserByLogin,
+        kFindUserById,
+        kListUsersAfter,
+        kCount
+    };
+
+    struct Statement {
+        Id id;
+        const char* name;
+        std::string sql;
+        Metrics::Query metric;
+    };
+
+    // Statement for a handle
+    static const Statement& get(Id id);
+
+    // Execute a statement; the query is timed under the statement's metrics series
+    // and, for a traced request, recorded as a span that the callbacks run under
+    template <typename... Arguments>
+    static void exec(const std::shared_ptr<drogon::orm::DbClient>& client,
+                     Id id,
+                     std::function<void(const drogon::orm::Result&)> onResult,
+                     std::function<void(const drogon::orm::DrogonDbException&)> onError,
+                     Arguments&&... args) {
+        const auto& statement = get(id);
+        auto timer = Metrics::startQuery(statement.metric);
+        auto trace = Tracer::current();
+        // Drogon does not report when a queued query reaches a connection, so the
+        // span covers both; "queued" marks a query submitted with no free connection
+        bool queued = trace && !client->hasAvailableConnections();
+        int64_t submittedUs = trace ? Tracer::nowMicros() : 0;
+        auto finish = [trace, queued, submittedUs, name = statement.name]() {
+            if (!trace) return;
+            std::string label = queued ? std::string(name) + " (queued)" : std::string();
+            Tracer::getInstance().record(trace, name, "db", submittedUs, Tracer::nowMicros(), label);
+        };
+        client->execSqlAsync(
+            statement.sql,
+            [onResult = std::move(onResult), timer, finish, trace](const drogon::orm::Result& r) {
+                timer.done(true);
+                finish();
+                Tracer::ContextScope scope(trace);
+                onResult(r);
+            },
+            [onError = std::move(onError), timer, finish, trace](const drogon::orm::DrogonDbException& e) {
+                timer.done(false);
+                finish();
+                Tracer::ContextScope scope(trace);
+                onError(e);
+            },
+            std::forward<Arguments>(args)...);
+    }
+};
@@ -0,0 +1,222 @@
+// StaticAssets.cpp
+#include "StaticAssets.h"
+#include "AsyncLog.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+using namespace drogon;
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* kImmutableCacheControl = "public, max-age=31536000, immutable";
+const char* kRevalidateCacheControl = "no-cache";
+
+// Whole file, or nothing if it cannot be read
+bool readFile(const fs::path& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    auto size = file.tellg();
+    if (size <= 0) return false;
+    out.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(out.data(), size));
+}
+
+// Same search as the views directory: next to the working directory or up to two levels up
+fs::path findDirectory(const fs::path& configured) {
+    if (configured.is_absolute()) return configured;
+    std::error_code ec;
+    for (const auto& base : {fs::current_path(), fs::current_path() / "..", fs::current_path() / ".." / ".."}) {
+        auto candidate = base / configured;
+        if (fs::exists(candidate / "asset-manifest.json", ec)) return candidate.lexically_normal();
+    }
+    return {};
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+}
+
+StaticAssets& StaticAssets::getInstance() {
+    static StaticAssets instance;
+    return instance;
+}
+
+bool StaticAssets::initialize(const Json::Value& config) {
+    auto directory = findDirectory(config.get("directory", "assets").asString());
+    if (directory.empty()) {
+        AsyncLog::info() << "Static assets: no asset-manifest.json found, serving public/ as is";
+        return false;
+    }
+
+    Json::Value manifest;
+    {
+        std::ifstream file(directory / "asset-manifest.json", std::ios::binary);
+        Json::CharReaderBuilder builder;
+        std::string errors;
+        if (!Json::parseFromStream(builder, file, &manifest, &errors) || !manifest["assets"].isArray()) {
+            AsyncLog::error() << "Static assets: invalid asset-manifest.json: " << errors;
+            return false;
+        }
+    }
+
+    std::vector<Asset> assets;
+    size_t loadedBytes = 0;
+    for (const auto& entry : manifest["assets"]) {
+        Asset asset;
+        asset.url = entry["url"].asString();
+        std::string path = entry["path"].asString();
+        asset.fingerprintedUrl = "/" + path;
+        std::string contentType = entry["content_type"].asString();
+        std::string hash = entry["hash"].asString();
+
+        if (!loadVariant(asset, kIdentity, directory / path, contentType, hash)) {
+            AsyncLog::error() << "Static assets: cannot read " << (directory / path).string();
+            continue;
+        }
+        for (const auto& encoding : entry["encodings"]) {
+            if (encoding.asString() == "br") {
+                loadVariant(asset, kBrotli, directory / (path + ".br"), contentType, hash);
+            } else if (encoding.asString() == "gzip") {
+                loadVariant(asset, kGzip, directory / (path + ".gz"), contentType, hash);
+            }
+        }
+        for (const auto& variant : asset.variants) {
+            if (variant.present) loadedBytes += variant.body.size();
+        }
+        assets.push_back(std::move(asset));
+    }
+
+    _assets = std::move(assets);
+    AsyncLog::info() << "Static assets: " << _assets.size() << " asset(s), " << loadedBytes
+                     << " bytes from " << directory.string();
+    return !_assets.empty();
+}
+
+bool StaticAssets::loadVariant(Asset& asset, Encoding encoding, const fs::path& path,
+                               const std::string& contentType, const std::string& hash) {
+    static const char* const kEtagSuffix[kEncodingCount] = {"", "-gzip", "-br"};
+    static const char* const kContentEncoding[kEncodingCount] = {nullptr, "gzip", "br"};
+
+    auto& variant = asset.variants[encoding];
+    if (!readFile(path, variant.body)) return false;
+    // Strong validator per representation: the encodings differ byte for byte
+    variant.etag = "\"" + hash + kEtagSuffix[encoding] + "\"";
+    variant.contentType = contentType;
+    variant.contentEncoding = kContentEncoding[encoding];
+    variant.responses = std::make_shared<IOThreadStorage<Responses>>();
+    variant.present = true;
+    return true;
+}
+
+const HttpResponsePtr& StaticAssets::threadResponse(const Variant& variant, CacheMode mode, bool notModified) {
+    auto& responses = variant.responses->getThreadData();
+    auto& resp = notModified ? responses.notModified[mode] : responses.full[mode];
+    if (resp) return resp;
+
+    resp = HttpResponse::newHttpResponse();
+    if (notModified) {
+        resp->setStatusCode(k304NotModified);
+    } else {
+        resp->setContentTypeString(variant.contentType);
+        resp->setBody(variant.body);
+        if (variant.contentEncoding) resp->addHeader("Content-Encoding", variant.contentEncoding);
+    }
+    resp->addHeader("ETag", variant.etag);
+    resp->addHeader("Cache-Control", mode == kImmutable ? kImmutableCacheControl : kRevalidateCacheControl);
+    resp->addHeader("Vary", "Accept-Encoding");
+    // Rendered once by drogon and reused, like the cached views
+    resp->setExpiredTime(0);
+    return resp;
+}
+
+StaticAssets::AcceptedEncodings StaticAssets::parseAcceptEncoding(std::string_view acceptEncoding) {
+    // Quality per coding; -1 means not listed
+    double brotli = -1, gzip = -1, any = -1;
+    while (!acceptEncoding.empty()) {
+        size_t comma = acceptEncoding.find(',');
+        auto item = trim(acceptEncoding.substr(0, comma));
+        acceptEncoding.remove_prefix(comma == std::string_view::npos ? acceptEncoding.size() : comma + 1);
+
+        size_t semicolon = item.find(';');
+        auto coding = trim(item.substr(0, semicolon));
+        double quality = 1;
+        if (semicolon != std::string_view::npos) {
+            auto params = item.substr(semicolon + 1);
+            size_t q = params.find("q=");
+            if (q != std::string_view::npos) quality = std::atof(std::string(params.substr(q + 2)).c_str());
+        }
+        if (equalsIgnoreCase(coding, "br")) brotli = quality;
+        else if (equalsIgnoreCase(coding, "gzip")) gzip = quality;
+        else if (coding == "*") any = quality;
+    }
+
+    auto accepted = [any](double quality) { return quality >= 0 ? quality > 0 : any > 0; };
+    AcceptedEncodings result;
+    result.gzip = accepted(gzip);
+    result.brotli = accepted(brotli);
+    return result;
+}
+
+StaticAssets::Encoding StaticAssets::chooseEncoding(const Asset& asset, std::string_view acceptEncoding) {
+    auto accepts = parseAcceptEncoding(acceptEncoding);
+    if (asset.variants[kBrotli].present && accepts.brotli) return kBrotli;
+    if (asset.variants[kGzip].present && accepts.gzip) return kGzip;
+    return kIdentity;
+}
+
+HttpResponsePtr StaticAssets::respond(const Asset& asset, CacheMode mode, const HttpRequestPtr& req) {
+    const auto& variant = asset.variants[chooseEncoding(asset, req->getHeader("accept-encoding"))];
+    const auto& ifNoneMatch = req->getHeader("if-none-match");
+    if (!ifNoneMatch.empty() &&
+        (ifNoneMatch == "*" || ifNoneMatch.find(variant.etag) != std::string::npos)) {
+        return threadResponse(variant, mode, true);
+    }
+    return threadResponse(variant, mode, false);
+}
+
+void StaticAssets::registerRoutes() {
+    for (const auto& asset : _assets) {
+        const Asset* entry = &asset;
+        app().registerHandler(asset.fingerprintedUrl,
+            [entry](const HttpRequestPtr& req,
+                    std::function<void(const HttpResponsePtr&)>&& callback) {
+                callback(respond(*entry, kImmutable, req));
+            },
+            {Get});
+        // Old links and un-rewritten pages still work, but revalidate every time
+        app().registerHandler(asset.url,
+            [entry](const HttpRequestPtr& req,
+                    std::function<void(const HttpResponsePtr&)>&& callback) {
+                callback(respond(*entry, kRevalidate, req));
+            },
+            {Get});
+    }
+}
+
+std::string StaticAssets::rewriteUrls(std::string html) const {
+    for (const auto& asset : _assets) {
+        for (char quote : {'"', '\''}) {
+            std::string from = quote + asset.url + quote;
+            std::string to = quote + asset.fingerprintedUrl + quote;
+            for (size_t pos = html.find(from); pos != std::string::npos; pos = html.find(from, pos + to.size())) {
+                html.replace(pos, from.size(), to);
+            }
+        }
+    }
+    return html;
+}
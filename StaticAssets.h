@@ -0,0 +1,89 @@
+// StaticAssets.h
+#pragma once
+#include <drogon/drogon.h>
+#include <drogon/IOThreadStorage.h>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Serves the fingerprinted, precompressed copy of public/ written by the
+// DrogonApp_assets build step (tools/AssetPipeline.cpp).
+//
+// Every variant (identity, gzip, brotli) is read once at startup. Each IO thread
+// builds its own responses from it on first use, so a request only picks the best
+// encoding the client accepts. Fingerprinted URLs are immutable for a year; the original URLs
+// keep working with the same strong ETags but must revalidate.
+class StaticAssets {
+public:
+    // Singleton instance
+    static StaticAssets& getInstance();
+
+    // Load asset-manifest.json and read every variant: { "directory": "assets" }.
+    // Returns false (serving nothing) if the pipeline output is not found.
+    bool initialize(const Json::Value& config);
+
+    // One exact-path handler per fingerprinted URL and per original URL
+    void registerRoutes();
+
+    // Replace quoted references to original asset URLs ("/css/x.css") with their
+    // fingerprinted URLs; html is returned untouched when nothing is loaded
+    std::string rewriteUrls(std::string html) const;
+
+    size_t assetCount() const { return _assets.size(); }
+
+    // Compressed codings a client accepts, from its Accept-Encoding header
+    // (q=0 refuses a coding; "*" covers the ones not listed)
+    struct AcceptedEncodings {
+        bool gzip = false;
+        bool brotli = false;
+    };
+    static AcceptedEncodings parseAcceptEncoding(std::string_view acceptEncoding);
+
+private:
+    StaticAssets() = default;
+    StaticAssets(const StaticAssets&) = delete;
+    StaticAssets& operator=(const StaticAssets&) = delete;
+
+    enum Encoding : size_t { kIdentity, kGzip, kBrotli, kEncodingCount };
+    enum CacheMode : size_t { kImmutable, kRevalidate, kCacheModeCount };
+
+    // Prebuilt responses of one IO thread; drogon renders them once and then reuses
+    // the buffer, which is only safe while a single loop sends them
+    struct Responses {
+        std::array<drogon::HttpResponsePtr, kCacheModeCount> full;
+        std::array<drogon::HttpResponsePtr, kCacheModeCount> notModified;
+    };
+
+    struct Variant {
+        bool present = false;
+        std::string etag;
+        std::string contentType;
+        const char* contentEncoding = nullptr;
+        std::string body;
+        std::shared_ptr<drogon::IOThreadStorage<Responses>> responses;
+    };
+
+    struct Asset {
+        std::string url;                // "/css/bootstrap.min.css"
+        std::string fingerprintedUrl;   // "/css/bootstrap.min.<hash>.css"
+        std::array<Variant, kEncodingCount> variants;
+    };
+
+    // Best variant the request accepts (identity always exists)
+    static Encoding chooseEncoding(const Asset& asset, std::string_view acceptEncoding);
+
+    static drogon::HttpResponsePtr respond(const Asset& asset, CacheMode mode,
+                                           const drogon::HttpRequestPtr& req);
+
+    // This thread's full or 304 response for a variant, built on first use
+    static const drogon::HttpResponsePtr& threadResponse(const Variant& variant, CacheMode mode,
+                                                         bool notModified);
+
+    bool loadVariant(Asset& asset, Encoding encoding, const std::filesystem::path& path,
+                     const std::string& contentType, const std::string& hash);
+
+    std::vector<Asset> _assets;
+};
@@ -0,0 +1,289 @@
+// TokenAuth.cpp
+#include "TokenAuth.h"
+#include "AsyncLog.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace drogon;
+
+namespace {
+
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderBytes = 11;                 // version, key id, expiry, user id, name length
+constexpr size_t kMaxPayloadBytes = kHeaderBytes + SessionData::kMaxUsername;
+constexpr size_t kMacBytes = 32;
+constexpr size_t kMacChars = 43;                    // base64url of 32 bytes, unpadded
+constexpr size_t kMinSecretBytes = 32;
+// Sample secret from older copies of config.json; public, so never accepted
+constexpr std::string_view kPlaceholderSecret = "replace-with-a-random-secret-of-32-bytes-or-more";
+constexpr size_t kBlockBytes = 64;                  // SHA-256 block size, for the HMAC pads
+
+constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+constexpr std::array<int8_t, 256> makeDecodeTable() {
+    std::array<int8_t, 256> table{};
+    for (auto& entry : table) entry = -1;
+    for (int i = 0; i < 64; ++i) table[static_cast<uint8_t>(kAlphabet[i])] = static_cast<int8_t>(i);
+    return table;
+}
+
+constexpr auto kDecodeTable = makeDecodeTable();
+
+constexpr size_t encodedSize(size_t bytes) {
+    return (bytes * 4 + 2) / 3;
+}
+
+void base64UrlEncode(const uint8_t* data, size_t size, std::string& out) {
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        out += kAlphabet[(v >> 6) & 63];
+        out += kAlphabet[v & 63];
+    }
+    if (size - i == 1) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+    } else if (size - i == 2) {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8);
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        out += kAlphabet[(v >> 6) & 63];
+    }
+}
+
+// Decode unpadded base64url into out (room for text.size() * 3 / 4 bytes); returns
+// the byte count, or -1 for a character outside the alphabet or an impossible length
+int base64UrlDecode(std::string_view text, uint8_t* out) {
+    if (text.size() % 4 == 1) return -1;
+    size_t written = 0;
+    uint32_t bits = 0;
+    int pending = 0;
+    for (char c : text) {
+        int8_t value = kDecodeTable[static_cast<uint8_t>(c)];
+        if (value < 0) return -1;
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        pending += 6;
+        if (pending >= 8) {
+            pending -= 8;
+            out[written++] = static_cast<uint8_t>(bits >> pending);
+        }
+    }
+    return static_cast<int>(written);
+}
+
+void putUint32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint32_t getUint32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint32_t unixNow() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+struct DigestContextDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+using DigestContext = std::unique_ptr<EVP_MD_CTX, DigestContextDeleter>;
+
+}
+
+// HMAC-SHA256 with the key pads already absorbed: a MAC is two context copies and
+// two short digests, with the key never rehashed per request
+struct TokenAuth::Key {
+    DigestContext inner;
+    DigestContext outer;
+
+    explicit Key(std::string_view secret) : inner(EVP_MD_CTX_new()), outer(EVP_MD_CTX_new()) {
+        uint8_t block[kBlockBytes] = {};
+        if (secret.size() > kBlockBytes) {
+            unsigned int length = 0;
+            EVP_Digest(secret.data(), secret.size(), block, &length, EVP_sha256(), nullptr);
+        } else {
+            std::memcpy(block, secret.data(), secret.size());
+        }
+
+        uint8_t pad[kBlockBytes];
+        for (size_t i = 0; i < kBlockBytes; ++i) pad[i] = block[i] ^ 0x36;
+        EVP_DigestInit_ex(inner.get(), EVP_sha256(), nullptr);
+        EVP_DigestUpdate(inner.get(), pad, kBlockBytes);
+        for (size_t i = 0; i < kBlockBytes; ++i) pad[i] = block[i] ^ 0x5c;
+        EVP_DigestInit_ex(outer.get(), EVP_sha256(), nullptr);
+        EVP_DigestUpdate(outer.get(), pad, kBlockBytes);
+
+        OPENSSL_cleanse(block, sizeof(block));
+        OPENSSL_cleanse(pad, sizeof(pad));
+    }
+
+    void mac(std::string_view data, uint8_t* out) const {
+        thread_local DigestContext work(EVP_MD_CTX_new());
+        uint8_t innerDigest[kMacBytes];
+        EVP_MD_CTX_copy_ex(work.get(), inner.get());
+        EVP_DigestUpdate(work.get(), data.data(), data.size());
+        EVP_DigestFinal_ex(work.get(), innerDigest, nullptr);
+        EVP_MD_CTX_copy_ex(work.get(), outer.get());
+        EVP_DigestUpdate(work.get(), innerDigest, kMacBytes);
+        EVP_DigestFinal_ex(work.get(), out, nullptr);
+    }
+};
+
+TokenAuth& TokenAuth::getInstance() {
+    static TokenAuth instance;
+    return instance;
+}
+
+TokenAuth::TokenAuth() = default;
+TokenAuth::~TokenAuth() = default;
+
+void TokenAuth::configure(const Json::Value& config) {
+    for (auto& key : _keys) key.reset();
+    _signingKey = -1;
+    _enabled = false;
+    if (!config.isObject()) return;
+
+    _cookieName = config.get("cookie_name", _cookieName).asString();
+    _secureCookie = config.get("secure_cookie", _secureCookie).asBool();
+    _ttl = std::chrono::seconds(std::max(1, config.get("ttl_seconds", 3600).asInt()));
+
+    const auto& keys = config["keys"];
+    for (const auto& entry : keys) {
+        int id = entry.get("id", -1).asInt();
+        std::string secret = entry.get("secret", "").asString();
+        if (id < 0 || id >= static_cast<int>(_keys.size())) {
+            AsyncLog::error() << "Auth tokens: key id " << id << " out of range 0-255, skipped";
+            continue;
+        }
+        if (secret.size() < kMinSecretBytes) {
+            AsyncLog::error() << "Auth tokens: key " << id << " is shorter than " << kMinSecretBytes
+                              << " bytes, skipped";
+            continue;
+        }
+        if (secret == kPlaceholderSecret) {
+            AsyncLog::error() << "Auth tokens: key " << id << " still has the sample secret, skipped";
+            continue;
+        }
+        _keys[id] = std::make_unique<Key>(secret);
+    }
+
+    int signingKey = config.get("signing_key", keys.empty() ? -1 : keys[0].get("id", -1).asInt()).asInt();
+    if (signingKey >= 0 && signingKey < static_cast<int>(_keys.size()) && _keys[signingKey]) {
+        _signingKey = signingKey;
+    }
+
+    bool wanted = config.get("enabled", false).asBool();
+    if (wanted && _signingKey < 0) {
+        AsyncLog::error() << "Auth tokens: no usable signing key, falling back to sessions";
+    }
+    _enabled = wanted && _signingKey >= 0;
+    if (_enabled) {
+        AsyncLog::info() << "Auth tokens: enabled, signing key " << _signingKey << ", ttl "
+                         << _ttl.count() << " s";
+    }
+}
+
+std::string TokenAuth::issue(const SessionData& claims) const {
+    if (_signingKey < 0) return {};
+
+    auto username = claims.username();
+    uint8_t payload[kMaxPayloadBytes];
+    payload[0] = kVersion;
+    payload[1] = static_cast<uint8_t>(_signingKey);
+    putUint32(payload + 2, unixNow() + static_cast<uint32_t>(_ttl.count()));
+    putUint32(payload + 6, static_cast<uint32_t>(claims.userId));
+    payload[10] = static_cast<uint8_t>(username.size());
+    std::memcpy(payload + kHeaderBytes, username.data(), username.size());
+    size_t payloadSize = kHeaderBytes + username.size();
+
+    std::string token;
+    token.reserve(encodedSize(payloadSize) + 1 + kMacChars);
+    base64UrlEncode(payload, payloadSize, token);
+
+    uint8_t mac[kMacBytes];
+    _keys[_signingKey]->mac(token, mac);
+    token += '.';
+    base64UrlEncode(mac, kMacBytes, token);
+
+    _issued.fetch_add(1, std::memory_order_relaxed);
+    return token;
+}
+
+std::optional<SessionData> TokenAuth::verify(std::string_view token) const {
+    auto reject = [this]() {
+        _rejected.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    };
+
+    // Shape first: everything below works on fixed-size stack buffers
+    size_t dot = token.find('.');
+    if (dot == std::string_view::npos || token.size() - dot - 1 != kMacChars ||
+        dot > encodedSize(kMaxPayloadBytes)) {
+        return reject();
+    }
+    std::string_view encodedPayload = token.substr(0, dot);
+
+    uint8_t payload[kMaxPayloadBytes + 2];
+    int payloadSize = base64UrlDecode(encodedPayload, payload);
+    if (payloadSize < static_cast<int>(kHeaderBytes) || payload[0] != kVersion) return reject();
+
+    const Key* key = _keys[payload[1]].get();
+    if (!key) return reject();
+
+    uint8_t expected[kMacBytes];
+    uint8_t presented[kMacBytes + 1];
+    key->mac(encodedPayload, expected);
+    if (base64UrlDecode(token.substr(dot + 1), presented) != static_cast<int>(kMacBytes) ||
+        CRYPTO_memcmp(expected, presented, kMacBytes) != 0) {
+        return reject();
+    }
+
+    // Authentic from here on; only expiry and the name length are left to check
+    if (getUint32(payload + 2) <= unixNow()) return reject();
+    size_t nameLength = payload[10];
+    if (kHeaderBytes + nameLength != static_cast<size_t>(payloadSize)) return reject();
+
+    SessionData claims;
+    claims.userId = static_cast<int>(getUint32(payload + 6));
+    claims.setUsername({reinterpret_cast<const char*>(payload + kHeaderBytes), nameLength});
+    return claims;
+}
+
+std::optional<SessionData> TokenAuth::find(const HttpRequestPtr& req) const {
+    const std::string& cookie = req->getCookie(_cookieName);
+    if (!cookie.empty()) return verify(cookie);
+
+    static constexpr std::string_view kBearer = "Bearer ";
+    const std::string& authorization = req->getHeader("authorization");
+    if (authorization.size() > kBearer.size() && authorization.compare(0, kBearer.size(), kBearer) == 0) {
+        return verify(std::string_view(authorization).substr(kBearer.size()));
+    }
+    return std::nullopt;
+}
+
+void TokenAuth::start(const HttpResponsePtr& resp, const SessionData& claims) const {
+    auto cookie = makeCookie(issue(claims));
+    cookie.setMaxAge(static_cast<int>(_ttl.count()));
+    resp->addCookie(cookie);
+}
+
+void TokenAuth::end(const HttpResponsePtr& resp) const {
+    auto cookie = makeCookie("");
+    cookie.setMaxAge(0);
+    resp->addCookie(cookie);
+}
+
+Cookie TokenAuth::makeCookie(const std::string& value) const {
+    Cookie cookie(_cookieName, value);
+    cookie.setPath("/");
+    cookie.setHttpOnly(true);
+    cookie.setSecure(_secureCookie);
+    cookie.setSameSite(Cookie::SameSite::kLax);
+    return cookie;
+}
@@ -0,0 +1,278 @@
+// Tracer.cpp
+#include "Tracer.h"
+#include "AsyncLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace drogon;
+
+namespace {
+
+const std::string kTraceAttribute = "trace_id";
+const std::string kRequestStartAttribute = "trace_request_us";
+const std::string kFiltersStartAttribute = "trace_filters_us";
+const std::string kHandlerStartAttribute = "trace_handler_us";
+
+void appendEscaped(std::string& out, std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+}
+
+Tracer::TraceId traceOf(const HttpRequestPtr& req) {
+    const auto& attributes = req->attributes();
+    return attributes->find(kTraceAttribute) ? attributes->get<Tracer::TraceId>(kTraceAttribute) : 0;
+}
+
+}
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+Tracer::TraceId& Tracer::currentSlot() {
+    thread_local TraceId trace = 0;
+    return trace;
+}
+
+int64_t Tracer::nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::configure(const Json::Value& config) {
+    if (!config.isObject() || _installed) return;
+
+    _enabled = config.get("enabled", false).asBool();
+    _sampleRate = std::clamp(config.get("sample_rate", 0.01).asDouble(), 0.0, 1.0);
+    _forceHeader = config.get("force_header", _forceHeader).asString();
+    _output = config.get("output", _output).asString();
+    _flushInterval = std::chrono::milliseconds(std::max(10, config.get("flush_ms", 1000).asInt()));
+
+    // Power of two so a ring index is a mask
+    size_t requested = std::max<Json::UInt>(64, config.get("ring_events", 8192).asUInt());
+    _ringEvents = 1;
+    while (_ringEvents < requested) _ringEvents <<= 1;
+}
+
+void Tracer::install() {
+    if (!_enabled || _installed) return;
+
+    _file.open(_output, std::ios::out | std::ios::trunc);
+    if (!_file.is_open()) {
+        AsyncLog::error() << "Tracer: cannot write " << _output << ", tracing disabled";
+        _enabled = false;
+        return;
+    }
+    // JSON array form of the trace format: the closing bracket is optional, so
+    // events are appended as they are flushed
+    _file << "[\n";
+    _installed = true;
+
+    app().registerPreRoutingAdvice([this](const HttpRequestPtr& req) {
+        TraceId trace = sample(req);
+        enterRequest(trace);
+        if (!trace) return;
+        req->attributes()->insert(kTraceAttribute, trace);
+        req->attributes()->insert(kRequestStartAttribute, nowMicros());
+    });
+
+    app().registerPostRoutingAdvice([](const HttpRequestPtr& req) {
+        TraceId trace = traceOf(req);
+        enterRequest(trace);
+        if (trace) req->attributes()->insert(kFiltersStartAttribute, nowMicros());
+    });
+
+    app().registerPreHandlingAdvice([this](const HttpRequestPtr& req) {
+        // An asynchronous filter may resume the chain on another thread
+        TraceId trace = traceOf(req);
+        enterRequest(trace);
+        if (!trace) return;
+        int64_t now = nowMicros();
+        const auto& attributes = req->attributes();
+        if (attributes->find(kFiltersStartAttribute)) {
+            record(trace, "filters", "filter", attributes->get<int64_t>(kFiltersStartAttribute), now);
+        }
+        attributes->insert(kHandlerStartAttribute, now);
+    });
+
+    app().registerPostHandlingAdvice([this](const HttpRequestPtr& req, const HttpResponsePtr& resp) {
+        // Runs wherever the response was produced, possibly not the thread that set
+        // the slot, so the slot is left to enterRequest's reset
+        TraceId trace = traceOf(req);
+        if (!trace) return;
+        int64_t now = nowMicros();
+        const auto& attributes = req->attributes();
+        if (attributes->find(kHandlerStartAttribute)) {
+            record(trace, "handler", "controller", attributes->get<int64_t>(kHandlerStartAttribute), now);
+        } else if (attributes->find(kFiltersStartAttribute)) {
+            // Answered by a filter (401, 429, ...)
+            record(trace, "filters", "filter", attributes->get<int64_t>(kFiltersStartAttribute), now);
+        }
+        std::string label = std::string(req->methodString()) + " " + req->path() + " " +
+                            std::to_string(static_cast<int>(resp->statusCode()));
+        record(trace, "request", "request", attributes->get<int64_t>(kRequestStartAttribute), now, label);
+    });
+
+    _writer = std::thread([this]() { writerLoop(); });
+
+    auto line = AsyncLog::info();
+    line << "Tracer: sampling " << _sampleRate * 100 << "% of requests";
+    if (!_forceHeader.empty()) line << " (always with " << _forceHeader << ")";
+    line << ", writing " << _output;
+}
+
+void Tracer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        if (!_writer.joinable()) return;
+        _stopping = true;
+    }
+    _writerWake.notify_all();
+    _writer.join();
+}
+
+void Tracer::enterRequest(TraceId trace) {
+    currentSlot() = trace;
+    if (!trace) return;
+
+    thread_local bool resetQueued = false;
+    auto* loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    if (resetQueued || !loop) return;
+    resetQueued = true;
+    // Pending functors run after the loop has finished dispatching the current I/O
+    loop->queueInLoop([]() {
+        currentSlot() = 0;
+        resetQueued = false;
+    });
+}
+
+Tracer::TraceId Tracer::sample(const HttpRequestPtr& req) {
+    bool traced = false;
+    if (!_forceHeader.empty()) {
+        const auto& forced = req->getHeader(_forceHeader);
+        traced = !forced.empty() && forced != "0";
+    }
+    if (!traced && _sampleRate > 0) {
+        thread_local std::minstd_rand random(std::random_device{}());
+        traced = std::uniform_real_distribution<double>(0.0, 1.0)(random) < _sampleRate;
+    }
+    if (!traced) return 0;
+
+    _sampled.fetch_add(1, std::memory_order_relaxed);
+    // Never 0, which means "not traced"
+    return _nextTrace.fetch_add(1, std::memory_order_relaxed) % 0xFFFFFFFFu + 1;
+}
+
+Tracer::Ring& Tracer::localRing() {
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        auto owned = std::make_unique<Ring>();
+        owned->events.resize(_ringEvents);
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        owned->thread = static_cast<uint32_t>(_rings.size() + 1);
+        ring = owned.get();
+        _rings.push_back(std::move(owned));
+    }
+    return *ring;
+}
+
+void Tracer::record(TraceId trace, const char* name, const char* category, int64_t startUs, int64_t endUs,
+                    std::string_view label) {
+    if (!trace || !_installed) return;
+
+    auto& ring = localRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= ring.events.size()) {
+        // Writer is behind: drop rather than block the request
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& event = ring.events[head & (ring.events.size() - 1)];
+    event.trace = trace;
+    event.thread = ring.thread;
+    event.startUs = startUs;
+    event.durationUs = std::max<int64_t>(0, endUs - startUs);
+    event.name = name;
+    event.category = category;
+    size_t length = std::min(label.size(), sizeof(event.label) - 1);
+    std::memcpy(event.label, label.data(), length);
+    event.label[length] = '\0';
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::writerLoop() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopping) {
+        _writerWake.wait_for(lock, _flushInterval, [this]() { return _stopping; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+size_t Tracer::flush() {
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        for (const auto& ring : _rings) rings.push_back(ring.get());
+    }
+
+    std::string out;
+    size_t written = 0;
+    auto separator = [this, &out]() {
+        if (!_firstEvent) out += ",\n";
+        _firstEvent = false;
+    };
+
+    for (auto* ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const auto& event = ring->events[tail & (ring->events.size() - 1)];
+            bool isRequest = std::strcmp(event.category, "request") == 0;
+
+            // Each request is a track named after it
+            if (isRequest) {
+                separator();
+                out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(event.trace) +
+                       ",\"args\":{\"name\":\"";
+                appendEscaped(out, event.label);
+                out += "\"}}";
+            }
+
+            separator();
+            out += "{\"name\":\"";
+            appendEscaped(out, event.label[0] ? std::string_view(event.label) : std::string_view(event.name));
+            out += "\",\"cat\":\"";
+            out += event.category;
+            out += "\",\"ph\":\"X\",\"ts\":" + std::to_string(event.startUs) +
+                   ",\"dur\":" + std::to_string(event.durationUs) +
+                   ",\"pid\":1,\"tid\":" + std::to_string(event.trace) +
+                   ",\"args\":{\"thread\":" + std::to_string(event.thread) + "}}";
+            ++written;
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    if (!out.empty()) {
+        _file << out;
+        _file.flush();
+    }
+    return written;
+}
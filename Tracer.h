@@ -0,0 +1,155 @@
+// Tracer.h
+#pragma once
+#include <drogon/drogon.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Sampled per-request tracing. A sampled request gets a trace id; spans recorded
+// under it (filters, handler, DB queries, hashing, JSON serialization) go into a
+// ring buffer owned by the recording thread, and a background thread appends
+// them to a Chrome trace file (chrome://tracing, ui.perfetto.dev). Each request
+// is shown as its own track.
+//
+// The trace of the request being handled is kept per thread. Code that continues
+// a request on another thread or in a later callback captures current() and
+// reinstates it with a ContextScope. For an unsampled request every span is a
+// thread-local read and a branch.
+class Tracer {
+public:
+    using TraceId = uint32_t;   // 0: not traced
+
+    // Singleton instance
+    static Tracer& getInstance();
+
+    ~Tracer();
+
+    // Configure from a config section:
+    //   { "enabled": false, "sample_rate": 0.01, "force_header": "x-trace",
+    //     "output": "trace.json", "ring_events": 8192, "flush_ms": 1000 }
+    // A request carrying force_header (any value but "0") is always traced.
+    // The output file is rewritten on every start.
+    void configure(const Json::Value& config);
+
+    // Register the advices that sample requests and time filters and handlers
+    void install();
+
+    // Write out what is buffered and stop the writer thread
+    void stop();
+
+    bool enabled() const { return _enabled; }
+
+    // Trace of the work running on this thread
+    static TraceId current() { return currentSlot(); }
+
+    // Record a finished span; label (copied, may be empty) replaces name in the output
+    void record(TraceId trace, const char* name, const char* category, int64_t startUs, int64_t endUs,
+                std::string_view label = {});
+
+    static int64_t nowMicros();
+
+    uint64_t sampledCount() const { return _sampled.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+    // Makes a trace current on this thread until the end of the scope
+    class ContextScope {
+    public:
+        explicit ContextScope(TraceId trace) : _previous(currentSlot()) { currentSlot() = trace; }
+        ~ContextScope() { currentSlot() = _previous; }
+        ContextScope(const ContextScope&) = delete;
+        ContextScope& operator=(const ContextScope&) = delete;
+
+    private:
+        TraceId _previous;
+    };
+
+    // Records the enclosing scope as a span of the current (or given) trace
+    class Span {
+    public:
+        Span(const char* name, const char* category) : Span(current(), name, category) {}
+        Span(TraceId trace, const char* name, const char* category)
+            : _trace(trace), _name(name), _category(category), _startUs(trace ? nowMicros() : 0) {}
+        ~Span() {
+            if (_trace) getInstance().record(_trace, _name, _category, _startUs, nowMicros());
+        }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        TraceId _trace;
+        const char* _name;
+        const char* _category;
+        int64_t _startUs;
+    };
+
+private:
+    struct Event {
+        TraceId trace = 0;
+        uint32_t thread = 0;
+        int64_t startUs = 0;
+        int64_t durationUs = 0;
+        const char* name = nullptr;
+        const char* category = nullptr;
+        char label[48] = {};
+    };
+
+    // Single producer (the owning thread), single consumer (the writer)
+    struct Ring {
+        std::vector<Event> events;
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> tail{0};
+        uint32_t thread = 0;
+    };
+
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static TraceId& currentSlot();
+
+    // Make a request's trace current on this thread. The same thread clears it once
+    // the event being handled has returned to its loop, so later callbacks queued
+    // there do not inherit the trace.
+    static void enterRequest(TraceId trace);
+
+    // Sampling decision for a new request; 0 if it is not traced
+    TraceId sample(const drogon::HttpRequestPtr& req);
+
+    // Ring of the calling thread, created and registered on first use
+    Ring& localRing();
+
+    void writerLoop();
+
+    // Move every ring's events to the file; returns the number written
+    size_t flush();
+
+    bool _enabled = false;
+    double _sampleRate = 0;
+    std::string _forceHeader = "x-trace";
+    std::string _output = "trace.json";
+    size_t _ringEvents = 8192;
+    std::chrono::milliseconds _flushInterval{1000};
+    bool _installed = false;
+
+    std::mutex _ringsMutex;
+    std::vector<std::unique_ptr<Ring>> _rings;
+
+    std::mutex _writerMutex;
+    std::condition_variable _writerWake;
+    bool _stopping = false;
+    std::thread _writer;
+    std::ofstream _file;
+    bool _firstEvent = true;
+
+    std::atomic<TraceId> _nextTrace{0};
+    std::atomic<uint64_t> _sampled{0};
+    std::atomic<uint64_t> _dropped{0};
+};
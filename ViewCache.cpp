@@ -0,0 +1,146 @@
+// ViewCache.cpp
+#include "ViewCache.h"
+#include "AsyncLog.h"
+#include "ViewLoader.h"
+#include "StaticAssets.h"
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace drogon;
+
+ViewCache& ViewCache::getInstance() {
+    static ViewCache instance;
+    return instance;
+}
+
+std::shared_ptr<const ViewCache::Entry> ViewCache::loadEntry(const fs::path& path) {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    auto body = std::make_shared<std::string>();
+    body->reserve(static_cast<size_t>(size));
+    body->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    // Link the fingerprinted, long-cached copies of /css, /js and /fonts
+    *body = StaticAssets::getInstance().rewriteUrls(std::move(*body));
+
+    auto entry = std::make_shared<Entry>();
+    entry->path = path;
+    entry->mtime = mtime;
+    entry->size = size;
+    entry->body = body;
+    entry->view = std::make_shared<ViewTemplate>(ViewTemplate::compile(*body));
+
+    return entry;
+}
+
+void ViewCache::initialize(double pollIntervalSeconds) {
+    const auto& directory = ViewLoader::viewsDirectory();
+    if (directory.empty()) {
+        AsyncLog::error() << "View cache: views directory not found";
+        return;
+    }
+
+    AsyncLog::info() << "View cache: loading views from " << directory.string();
+
+    size_t loaded = 0;
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(directory, ec)) {
+        if (!file.is_regular_file() || file.path().extension() != ".html") continue;
+
+        auto entry = loadEntry(file.path());
+        if (!entry) continue;
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _entries[file.path().stem().string()] = entry;
+        ++loaded;
+    }
+
+    AsyncLog::info() << "View cache: " << loaded << " view(s) cached";
+
+    if (!_watching && pollIntervalSeconds > 0) {
+        _watching = true;
+        app().getLoop()->runEvery(pollIntervalSeconds, [this]() { refresh(); });
+    }
+}
+
+void ViewCache::refresh() {
+    std::vector<std::pair<std::string, std::shared_ptr<const Entry>>> current;
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        current.assign(_entries.begin(), _entries.end());
+    }
+
+    for (const auto& [name, entry] : current) {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(entry->path, ec);
+        if (ec) continue; // Keep serving the last good copy
+        auto size = fs::file_size(entry->path, ec);
+        if (ec || (mtime == entry->mtime && size == entry->size)) continue;
+
+        auto reloaded = loadEntry(entry->path);
+        if (!reloaded) continue;
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _entries[name] = reloaded;
+        ++_reloads;
+        AsyncLog::info() << "View cache: reloaded " << name;
+    }
+}
+
+std::shared_ptr<const ViewCache::Entry> ViewCache::findEntry(const std::string& viewName) {
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(viewName);
+        if (it != _entries.end()) {
+            return it->second;
+        }
+    }
+
+    if (ViewLoader::viewsDirectory().empty()) {
+        return nullptr;
+    }
+
+    // Not cached yet (added after startup or initialize() not called)
+    auto entry = loadEntry(ViewLoader::viewPath(viewName));
+    if (!entry) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    auto inserted = _entries.emplace(viewName, entry);
+    return inserted.first->second;
+}
+
+std::shared_ptr<const std::string> ViewCache::getView(const std::string& viewName) {
+    auto entry = findEntry(viewName);
+    return entry ? entry->body : nullptr;
+}
+
+std::shared_ptr<const ViewTemplate> ViewCache::getTemplate(const std::string& viewName) {
+    auto entry = findEntry(viewName);
+    return entry ? entry->view : nullptr;
+}
+
+std::string ViewCache::render(const std::string& viewName,
+                              const std::unordered_map<std::string, std::string>& values) {
+    auto view = getTemplate(viewName);
+    if (!view) {
+        throw std::runtime_error("View file not found: " + viewName + ".html");
+    }
+    return view->render(values);
+}
@@ -0,0 +1,60 @@
+// ViewCache.h
+#pragma once
+#include <drogon/drogon.h>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "ViewTemplate.h"
+
+// Keeps rendered views in memory and reloads them when the file on disk changes
+class ViewCache {
+public:
+    // Singleton instance
+    static ViewCache& getInstance();
+
+    // Load every view from the views directory and start the change watcher
+    void initialize(double pollIntervalSeconds = 2.0);
+
+    // Get view body (nullptr if the view does not exist)
+    std::shared_ptr<const std::string> getView(const std::string& viewName);
+
+    // Get compiled template for a view (nullptr if the view does not exist)
+    std::shared_ptr<const ViewTemplate> getTemplate(const std::string& viewName);
+
+    // Render a view's {{NAME}} slots with HTML-escaped values
+    std::string render(const std::string& viewName,
+                       const std::unordered_map<std::string, std::string>& values);
+
+    // Re-check every cached view and reload the ones that changed on disk
+    void refresh();
+
+    // Number of reloads since startup
+    size_t reloadCount() const { return _reloads; }
+
+private:
+    ViewCache() = default;
+    ViewCache(const ViewCache&) = delete;
+    ViewCache& operator=(const ViewCache&) = delete;
+
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type mtime;
+        uintmax_t size = 0;
+        std::shared_ptr<const std::string> body;
+        std::shared_ptr<const ViewTemplate> view;
+    };
+
+    // Read a view from disk into a new entry (nullptr if missing)
+    static std::shared_ptr<const Entry> loadEntry(const std::filesystem::path& path);
+
+    // Find entry, loading it on first use
+    std::shared_ptr<const Entry> findEntry(const std::string& viewName);
+
+    mutable std::shared_mutex _mutex;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> _entries;
+    std::atomic<size_t> _reloads{0};
+    bool _watching = false;
+};
@@ -4,51 +4,63 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include "ViewTemplate.h"
 
 namespace fs = std::filesystem;
 
 class ViewLoader {
 public:
+    // Locate the views directory once; empty path if it cannot be found
+    static const fs::path& viewsDirectory() {
+        static const fs::path directory = findViewsDirectory();
+        return directory;
+    }
+
+    // Full path of a view file inside the views directory
+    static fs::path viewPath(const std::string& viewName) {
+        return viewsDirectory() / (viewName + ".html");
+    }
+
     // Load HTML file and return as string
     static std::string loadView(const std::string& viewName) {
-        // Try multiple paths for views directory
-        std::vector<fs::path> possiblePaths = {
-            fs::current_path() / "views" / (viewName + ".html"),
-            fs::current_path() / ".." / "views" / (viewName + ".html"),
-            fs::current_path() / ".." / ".." / "views" / (viewName + ".html"),
-            fs::path("views") / (viewName + ".html"),
-            fs::path("..") / "views" / (viewName + ".html"),
-            fs::path("..") / ".." / "views" / (viewName + ".html")
-        };
-        
-        for (const auto& viewPath : possiblePaths) {
-            if (fs::exists(viewPath)) {
-                std::ifstream file(viewPath);
-                if (file.is_open()) {
-                    std::stringstream buffer;
-                    buffer << file.rdbuf();
-                    return buffer.str();
-                }
+        if (!viewsDirectory().empty()) {
+            std::ifstream file(viewPath(viewName), std::ios::binary);
+            if (file.is_open()) {
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                return buffer.str();
             }
         }
-        
+
         throw std::runtime_error("View file not found: " + viewName + ".html");
     }
-    
-    // Load view and replace placeholders
-    static std::string loadViewWithData(const std::string& viewName, 
+
+    // Load view and replace placeholder {{PLACEHOLDER}} with the HTML-escaped value
+    static std::string loadViewWithData(const std::string& viewName,
                                        const std::string& placeholder,
                                        const std::string& value) {
-        std::string html = loadView(viewName);
-        
-        // Replace placeholder {{PLACEHOLDER}} with value
-        std::string search = "{{" + placeholder + "}}";
-        size_t pos = 0;
-        while ((pos = html.find(search, pos)) != std::string::npos) {
-            html.replace(pos, search.length(), value);
-            pos += value.length();
+        auto view = ViewTemplate::compile(loadView(viewName));
+        return view.render(std::unordered_map<std::string, std::string>{{placeholder, value}});
+    }
+
+private:
+    static fs::path findViewsDirectory() {
+        // Try multiple paths for views directory
+        std::vector<fs::path> possiblePaths = {
+            fs::current_path() / "views",
+            fs::current_path() / ".." / "views",
+            fs::current_path() / ".." / ".." / "views"
+        };
+
+        std::error_code ec;
+        for (const auto& dir : possiblePaths) {
+            if (fs::is_directory(dir, ec)) {
+                return dir.lexically_normal();
+            }
         }
-        
-        return html;
+
+        return {};
     }
 };
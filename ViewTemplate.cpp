@@ -0,0 +1,132 @@
+// ViewTemplate.cpp
+#include "ViewTemplate.h"
+#include <cstring>
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+}
+
+ViewTemplate ViewTemplate::compile(std::string text) {
+    ViewTemplate tpl;
+    tpl._source = std::move(text);
+    std::string_view source(tpl._source);
+
+    size_t literalStart = 0;
+    size_t pos = 0;
+    while ((pos = source.find("{{", pos)) != std::string_view::npos) {
+        size_t close = source.find("}}", pos + 2);
+        if (close == std::string_view::npos) break;
+
+        auto name = trim(source.substr(pos + 2, close - pos - 2));
+        if (name.empty() || name.find('{') != std::string_view::npos) {
+            // Not a slot, keep it as literal text
+            pos += 2;
+            continue;
+        }
+
+        if (pos > literalStart) {
+            tpl._segments.push_back({literalStart, pos - literalStart, -1});
+            tpl._literalLength += pos - literalStart;
+        }
+
+        int slot = tpl.slotIndex(name);
+        if (slot < 0) {
+            slot = static_cast<int>(tpl._slotNames.size());
+            tpl._slotNames.emplace_back(name);
+        }
+        tpl._segments.push_back({pos, close + 2 - pos, slot});
+
+        pos = close + 2;
+        literalStart = pos;
+    }
+
+    if (literalStart < source.size()) {
+        tpl._segments.push_back({literalStart, source.size() - literalStart, -1});
+        tpl._literalLength += source.size() - literalStart;
+    }
+
+    return tpl;
+}
+
+int ViewTemplate::slotIndex(std::string_view name) const {
+    for (size_t i = 0; i < _slotNames.size(); ++i) {
+        if (_slotNames[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+size_t ViewTemplate::escapedLength(std::string_view value) {
+    size_t length = value.size();
+    for (char c : value) {
+        switch (c) {
+            case '&':
+            case '\'': length += 4; break; // &amp; &#39;
+            case '<':
+            case '>': length += 3; break;  // &lt; &gt;
+            case '"': length += 5; break;  // &quot;
+            default: break;
+        }
+    }
+    return length;
+}
+
+char* ViewTemplate::writeEscaped(char* out, std::string_view value) {
+    for (char c : value) {
+        switch (c) {
+            case '&': std::memcpy(out, "&amp;", 5); out += 5; break;
+            case '<': std::memcpy(out, "&lt;", 4); out += 4; break;
+            case '>': std::memcpy(out, "&gt;", 4); out += 4; break;
+            case '"': std::memcpy(out, "&quot;", 6); out += 6; break;
+            case '\'': std::memcpy(out, "&#39;", 5); out += 5; break;
+            default: *out++ = c; break;
+        }
+    }
+    return out;
+}
+
+std::string ViewTemplate::render(const std::vector<std::string_view>& values) const {
+    auto hasValue = [&values](int slot) {
+        return static_cast<size_t>(slot) < values.size() && values[slot].data() != nullptr;
+    };
+
+    // Size the output exactly, then write every segment straight into it
+    std::vector<size_t> slotLengths(_slotNames.size(), 0);
+    for (size_t i = 0; i < slotLengths.size() && i < values.size(); ++i) {
+        slotLengths[i] = escapedLength(values[i]);
+    }
+
+    size_t total = _literalLength;
+    for (const auto& segment : _segments) {
+        if (segment.slot < 0) continue;
+        total += hasValue(segment.slot) ? slotLengths[segment.slot] : segment.length;
+    }
+
+    std::string out(total, '\0');
+    char* cursor = out.data();
+    for (const auto& segment : _segments) {
+        if (segment.slot >= 0 && hasValue(segment.slot)) {
+            cursor = writeEscaped(cursor, values[segment.slot]);
+        } else {
+            std::memcpy(cursor, _source.data() + segment.offset, segment.length);
+            cursor += segment.length;
+        }
+    }
+    return out;
+}
+
+std::string ViewTemplate::render(const std::unordered_map<std::string, std::string>& values) const {
+    std::vector<std::string_view> ordered(_slotNames.size());
+    for (size_t i = 0; i < _slotNames.size(); ++i) {
+        auto it = values.find(_slotNames[i]);
+        if (it != values.end()) {
+            ordered[i] = it->second;
+        }
+    }
+    return render(ordered);
+}
@@ -0,0 +1,50 @@
+// ViewTemplate.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// View parsed once into literal runs and {{NAME}} slots, rendered in a single pass
+class ViewTemplate {
+public:
+    ViewTemplate() = default;
+
+    // Parse template text; slot names are the trimmed text between {{ and }}
+    static ViewTemplate compile(std::string text);
+
+    // Slot names in order of first appearance
+    const std::vector<std::string>& slotNames() const { return _slotNames; }
+
+    // Index of a slot by name (-1 if the template has no such slot)
+    int slotIndex(std::string_view name) const;
+
+    // Total length of the literal text between slots
+    size_t literalLength() const { return _literalLength; }
+
+    // Render with one value per slot index; values are HTML-escaped.
+    // Slots without a value (past the end or a default-constructed view)
+    // keep their {{NAME}} text.
+    std::string render(const std::vector<std::string_view>& values) const;
+
+    // Render with values by slot name; unknown names are ignored
+    std::string render(const std::unordered_map<std::string, std::string>& values) const;
+
+    // Escape &, <, >, " and ' for HTML text and attribute values.
+    // writeEscaped needs escapedLength(value) bytes at `out` and returns the new end.
+    static size_t escapedLength(std::string_view value);
+    static char* writeEscaped(char* out, std::string_view value);
+
+private:
+    struct Segment {
+        size_t offset = 0;  // Start in _source (literal text or the raw {{NAME}})
+        size_t length = 0;
+        int slot = -1;      // -1 for literal runs
+    };
+
+    std::string _source;
+    std::vector<Segment> _segments;
+    std::vector<std::string> _slotNames;
+    size_t _literalLength = 0;
+};
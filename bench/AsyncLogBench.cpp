@@ -0,0 +1,88 @@
+// AsyncLogBench.cpp - queuing a log line or access record vs a synchronous std::endl write
+#include "Bench.h"
+#include "AsyncLog.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kProducers = 8;
+constexpr size_t kRecordsPerProducer = 200000;
+
+std::string benchFile(const char* name) {
+    return std::string(P_tmpdir) + "/drogonapp_bench_" + name;
+}
+
+// Files only, so the numbers do not include a terminal
+void configureLog() {
+    static const bool configured = []() {
+        Json::Value config;
+        config["console"] = false;
+        config["file"] = benchFile("app.log");
+        config["access_log"] = benchFile("access.log");
+        config["max_file_bytes"] = 64 * 1024 * 1024;
+        config["max_files"] = 1;
+        AsyncLog::getInstance().configure(config);
+        return true;
+    }();
+    (void)configured;
+}
+
+void runOverload() {
+    configureLog();
+    auto& log = AsyncLog::getInstance();
+    uint64_t writtenBefore = log.writtenCount();
+    uint64_t droppedBefore = log.droppedCount();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < kProducers; ++t) {
+        producers.emplace_back([&log, t]() {
+            for (size_t i = 0; i < kRecordsPerProducer; ++i) {
+                log.access(drogon::Post, "/api/login", 200, 500 + i % 1000, static_cast<int>(t + 1));
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // Let the writer catch up before reading its counter
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::cout << kProducers * kRecordsPerProducer << " records from " << kProducers << " threads in " << ms
+              << " ms: " << log.writtenCount() - writtenBefore << " written, "
+              << log.droppedCount() - droppedBefore << " dropped" << std::endl;
+}
+
+}
+
+BENCHMARK("async_log/info_line", [](size_t n) {
+    configureLog();
+    for (size_t i = 0; i < n; ++i) {
+        AsyncLog::info() << "Database connected: default - " << i << " connection(s) " << 1.25 << " ms";
+    }
+});
+
+BENCHMARK("async_log/access_record", [](size_t n) {
+    configureLog();
+    auto& log = AsyncLog::getInstance();
+    for (size_t i = 0; i < n; ++i) {
+        log.access(drogon::Get, "/api/me", 200, 1834, 42);
+    }
+});
+
+// What every line cost before: format and flush to a file on the calling thread
+BENCHMARK("async_log/baseline/ofstream_endl", [](size_t n) {
+    static std::ofstream file(benchFile("endl.log"), std::ios::out | std::ios::trunc);
+    for (size_t i = 0; i < n; ++i) {
+        file << "Database connected: default - " << i << " connection(s) " << 1.25 << " ms" << std::endl;
+    }
+});
+
+// Producers outrun the writer: records are dropped and counted, nobody blocks
+BENCH_SCENARIO("async_log/overload_8_producers", []() {
+    runOverload();
+});
@@ -0,0 +1,45 @@
+// AuthFilterBench.cpp - full AuthFilter::doFilter for the request kinds it sees
+#include "Bench.h"
+#include "AuthFilter.h"
+
+namespace {
+
+drogon::HttpRequestPtr requestFor(const std::string& path) {
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setMethod(drogon::Get);
+    req->setPath(path);
+    return req;
+}
+
+// Run doFilter n times on one request; counts the requests let through
+void runFilter(const std::string& path, size_t n) {
+    AuthFilter filter;
+    auto req = requestFor(path);
+    size_t passed = 0;
+    for (size_t i = 0; i < n; ++i) {
+        filter.doFilter(req,
+                        [](const drogon::HttpResponsePtr& resp) { bench::escape(resp.get()); },
+                        [&passed]() { ++passed; });
+    }
+    bench::escape(&passed);
+}
+
+}
+
+// Static assets and public pages: policy lookup only
+BENCHMARK("auth_filter/do_filter/public_asset", [](size_t n) {
+    runFilter("/css/bootstrap.min.css", n);
+});
+
+BENCHMARK("auth_filter/do_filter/public_page", [](size_t n) {
+    runFilter("/login", n);
+});
+
+// No session: JSON 401 for the API, redirect for pages
+BENCHMARK("auth_filter/do_filter/api_unauthenticated", [](size_t n) {
+    runFilter("/api/v1/users", n);
+});
+
+BENCHMARK("auth_filter/do_filter/page_unauthenticated", [](size_t n) {
+    runFilter("/dashboard", n);
+});
@@ -0,0 +1,47 @@
+// Bench.h
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness used by DrogonApp_bench
+namespace bench {
+
+// Benchmark body: run the measured work `iterations` times
+using BenchFunction = std::function<void(size_t iterations)>;
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;
+    double nsPerOp = 0;
+};
+
+// Register a benchmark (used through BENCHMARK below)
+int registerBenchmark(const std::string& name, BenchFunction fn);
+
+// Register a scenario that runs once and prints its own report (latency percentiles, throughput)
+int registerScenario(const std::string& name, std::function<void()> fn);
+
+// Value at percentile p (0-100) of unsorted samples
+double percentile(std::vector<double> samples, double p);
+
+// Run every benchmark whose name contains `filter` and print a table
+std::vector<Result> runAll(const std::string& filter);
+
+// Keep a result alive so the optimizer cannot drop the benchmarked work
+inline void escape(const void* p) {
+    static const void* volatile sink = nullptr;
+    sink = p;
+    (void)sink;
+}
+
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(name, fn) \
+    static int BENCH_CONCAT(benchRegistration_, __LINE__) = bench::registerBenchmark(name, fn)
+#define BENCH_SCENARIO(name, fn) \
+    static int BENCH_CONCAT(benchScenario_, __LINE__) = bench::registerScenario(name, fn)
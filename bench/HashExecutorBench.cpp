@@ -0,0 +1,135 @@
+// HashExecutorBench.cpp - login latency with hashing inline on the IO loop vs on HashExecutor
+#include "Bench.h"
+#include "HashExecutor.h"
+#include <drogon/utils/Utilities.h>
+#include <trantor/net/EventLoopThread.h>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kRequests = 2000;
+constexpr size_t kLoginEvery = 10;       // 1 in 10 requests is a login
+constexpr size_t kClients = 8;           // Concurrent request producers
+constexpr size_t kKdfRounds = 2000;      // Stand-in for a slow KDF (a few ms)
+
+std::string slowHash(const std::string& password) {
+    std::string digest = password;
+    for (size_t i = 0; i < kKdfRounds; ++i) {
+        digest = drogon::utils::getSha256(digest);
+    }
+    return digest;
+}
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Clients post requests to one IO loop; every 10th is a login needing a slow hash
+void runScenario(bool usePool) {
+    trantor::EventLoopThread loopThread("bench-io");
+    loopThread.run();
+    auto* loop = loopThread.getLoop();
+
+    if (usePool) {
+        HashExecutor::getInstance().start(2, 4096);
+    }
+
+    std::mutex mutex;
+    std::vector<double> loginLatencies;
+    std::vector<double> otherLatencies;
+    std::promise<void> finished;
+    std::atomic<size_t> remaining{kRequests};
+
+    auto complete = [&](bool login, Clock::time_point start) {
+        double latency = millisSince(start);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            (login ? loginLatencies : otherLatencies).push_back(latency);
+        }
+        if (remaining.fetch_sub(1) == 1) finished.set_value();
+    };
+
+    auto benchStart = Clock::now();
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < kClients; ++c) {
+        clients.emplace_back([&, c]() {
+            for (size_t i = c; i < kRequests; i += kClients) {
+                bool login = i % kLoginEvery == 0;
+                auto start = Clock::now();
+                loop->queueInLoop([&, login, start]() {
+                    if (!login) {
+                        complete(false, start);
+                    } else if (!usePool) {
+                        bench::escape(slowHash("password").data());
+                        complete(true, start);
+                    } else {
+                        HashExecutor::getInstance().submit<std::string>(
+                            loop,
+                            []() { return slowHash("password"); },
+                            [&, start](std::optional<std::string> digest) {
+                                bench::escape(digest->data());
+                                complete(true, start);
+                            });
+                    }
+                });
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+    }
+
+    for (auto& client : clients) client.join();
+    finished.get_future().wait();
+    double totalSeconds = millisSince(benchStart) / 1000.0;
+
+    if (usePool) {
+        HashExecutor::getInstance().stop();
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << (usePool ? "hash pool   " : "inline hash ")
+              << " login p50 " << bench::percentile(loginLatencies, 50) << " ms"
+              << "  login p99 " << bench::percentile(loginLatencies, 99) << " ms"
+              << "  other p99 " << bench::percentile(otherLatencies, 99) << " ms"
+              << "  throughput " << static_cast<double>(kRequests) / totalSeconds << " req/s"
+              << std::endl;
+}
+
+}
+
+BENCH_SCENARIO("hash_executor/login_latency_under_load", []() {
+    runScenario(false);
+    runScenario(true);
+});
+
+// The password scheme itself: one SHA256 hex digest per register/login
+BENCHMARK("hash/sha256/compute_hash", [](size_t n) {
+    const std::string password = "correct horse battery staple";
+    for (size_t i = 0; i < n; ++i) {
+        auto digest = HashExecutor::computeHash(password);
+        bench::escape(digest.data());
+    }
+});
+
+BENCHMARK("hash/sha256/check_hash", [](size_t n) {
+    const std::string password = "correct horse battery staple";
+    const std::string stored = HashExecutor::computeHash(password);
+    size_t matches = 0;
+    for (size_t i = 0; i < n; ++i) {
+        matches += HashExecutor::checkHash(password, stored);
+    }
+    bench::escape(&matches);
+});
+
+BENCHMARK("hash/sha256/compute_hash_4k", [](size_t n) {
+    const std::string input(4096, 'x');
+    for (size_t i = 0; i < n; ++i) {
+        auto digest = drogon::utils::getSha256(input);
+        bench::escape(digest.data());
+    }
+});
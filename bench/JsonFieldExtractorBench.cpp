@@ -0,0 +1,75 @@
+// JsonFieldExtractorBench.cpp - login/register body parsing: jsoncpp DOM against JsonFieldExtractor
+#include "Bench.h"
+#include "JsonFieldExtractor.h"
+#include <json/json.h>
+#include <memory>
+
+namespace {
+
+const std::string kLoginBody = R"({"username":"bench_user","password":"correct horse battery staple"})";
+const std::string kRegisterBody =
+    R"({"username":"bench_user","email":"bench.user@example.com","password":"correct horse battery staple"})";
+
+const char* const kLoginKeys[] = {"username", "password"};
+const char* const kRegisterKeys[] = {"username", "email", "password"};
+
+// What getJsonObject() plus the old asString() copies cost
+template <size_t N>
+void parseWithDom(const std::string& body, const char* const (&keys)[N], size_t n) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto json = std::make_shared<Json::Value>();
+        std::string errors;
+        reader->parse(body.data(), body.data() + body.size(), json.get(), &errors);
+        for (const char* key : keys) {
+            std::string value = (*json)[key].asString();
+            bytes += value.size();
+        }
+    }
+    bench::escape(&bytes);
+}
+
+}
+
+BENCHMARK("auth_body/login/jsoncpp_dom", [](size_t n) {
+    parseWithDom(kLoginBody, kLoginKeys, n);
+});
+
+BENCHMARK("auth_body/login/field_extractor", [](size_t n) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        JsonFieldExtractor fields({"username", "password"});
+        if (fields.parse(kLoginBody) == JsonFieldExtractor::Status::kOk) {
+            bytes += fields.get(0).size() + fields.get(1).size();
+        }
+    }
+    bench::escape(&bytes);
+});
+
+BENCHMARK("auth_body/register/jsoncpp_dom", [](size_t n) {
+    parseWithDom(kRegisterBody, kRegisterKeys, n);
+});
+
+BENCHMARK("auth_body/register/field_extractor", [](size_t n) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        JsonFieldExtractor fields({"username", "email", "password"});
+        if (fields.parse(kRegisterBody) == JsonFieldExtractor::Status::kOk) {
+            bytes += fields.get(0).size() + fields.get(1).size() + fields.get(2).size();
+        }
+    }
+    bench::escape(&bytes);
+});
+
+// Rejection of an oversized body is a size check, not a parse
+BENCHMARK("auth_body/oversized/field_extractor", [](size_t n) {
+    static const std::string body = "{\"username\":\"" + std::string(64 * 1024, 'x') + "\"}";
+    size_t rejected = 0;
+    for (size_t i = 0; i < n; ++i) {
+        JsonFieldExtractor fields({"username", "password"});
+        rejected += fields.parse(body) == JsonFieldExtractor::Status::kTooLarge;
+    }
+    bench::escape(&rejected);
+});
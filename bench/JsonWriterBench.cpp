@@ -0,0 +1,90 @@
+// JsonWriterBench.cpp - auth response bodies: Json::Value + writer against JsonWriter
+#include "Bench.h"
+#include "AuthResponses.h"
+#include <json/json.h>
+
+namespace {
+
+const User kUser(42, "bench_user", "bench.user@example.com");
+
+// Compact, like the body Drogon's newHttpJsonResponse writes
+const Json::StreamWriterBuilder& compactBuilder() {
+    static const Json::StreamWriterBuilder builder = []() {
+        Json::StreamWriterBuilder b;
+        b["indentation"] = "";
+        return b;
+    }();
+    return builder;
+}
+
+}
+
+BENCHMARK("json/user/json_value", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto body = Json::writeString(compactBuilder(), kUser.toJson());
+        bench::escape(body.data());
+    }
+});
+
+BENCHMARK("json/user/json_writer", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto body = toJsonString(kUser);
+        bench::escape(body.data());
+    }
+});
+
+BENCHMARK("json/login_response/json_value", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Json::Value respJson;
+        respJson["success"] = true;
+        respJson["user"] = kUser.toJson();
+        auto body = Json::writeString(compactBuilder(), respJson);
+        bench::escape(body.data());
+    }
+});
+
+BENCHMARK("json/login_response/json_writer", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto body = toJsonString(LoginBody{true, &kUser});
+        bench::escape(body.data());
+    }
+});
+
+BENCHMARK("json/error_response/json_value", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Json::Value respJson;
+        respJson["error"] = "Invalid credentials";
+        auto body = Json::writeString(compactBuilder(), respJson);
+        bench::escape(body.data());
+    }
+});
+
+BENCHMARK("json/error_response/json_writer", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto body = toJsonString(ErrorBody{"Invalid credentials"});
+        bench::escape(body.data());
+    }
+});
+
+// Export page of 1000 rows, as /api/v1/users?export=ndjson builds it
+BENCHMARK("json/export_page/json_value", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        std::string chunk;
+        for (int row = 0; row < 1000; ++row) {
+            chunk += Json::writeString(compactBuilder(), kUser.toJson());
+            chunk += "\n";
+        }
+        bench::escape(chunk.data());
+    }
+});
+
+BENCHMARK("json/export_page/json_writer", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        std::string chunk;
+        for (int row = 0; row < 1000; ++row) {
+            writeJson(chunk, kUser);
+            chunk += "\n";
+        }
+        bench::escape(chunk.data());
+    }
+});
@@ -0,0 +1,315 @@
+// LoadDriver.cpp - end-to-end load against a running DrogonApp
+//
+// Usage: DrogonApp_load [--url http://127.0.0.1:8080] [--concurrency 32] [--duration 30]
+//                       [--warmup 3] [--threads 4] [--mix all|pages|api] [--out load-results.json]
+//
+// Start the server first with config.json pointing at a local, throwaway PostgreSQL
+// and "rate_limit": { "enabled": false }; every virtual user logs in from the same IP.
+//
+// Each virtual user has its own connection and cookie jar and loops over its script:
+//   pages: GET /, GET /login, GET /health
+//   api:   POST /api/login, GET /api/me, POST /api/logout (after one POST /api/register)
+// Latency is measured from send to response; samples taken during --warmup are dropped.
+// Per-endpoint throughput, status counts and percentiles go to stdout and to --out as JSON.
+#include <drogon/drogon.h>
+#include <drogon/HttpClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::string url = "http://127.0.0.1:8080";
+    size_t concurrency = 32;
+    double durationSeconds = 30;
+    double warmupSeconds = 3;
+    size_t threads = 4;
+    std::string mix = "all";
+    std::string out = "load-results.json";
+};
+
+struct Step {
+    std::string name;       // "GET /", used as the report key
+    HttpMethod method;
+    std::string path;
+    bool jsonBody;          // Sends the virtual user's credentials
+};
+
+struct EndpointStats {
+    std::vector<double> latencies;          // ms
+    std::map<int, size_t> statuses;
+    size_t transportErrors = 0;
+};
+
+// Everything one virtual user measured; merged once the run is over
+using Samples = std::map<std::string, EndpointStats>;
+
+std::vector<Step> scriptFor(const std::string& mix) {
+    std::vector<Step> pages = {
+        {"GET /", Get, "/", false},
+        {"GET /login", Get, "/login", false},
+        {"GET /health", Get, "/health", false},
+    };
+    std::vector<Step> api = {
+        {"POST /api/login", Post, "/api/login", true},
+        {"GET /api/me", Get, "/api/me", false},
+        {"POST /api/logout", Post, "/api/logout", false},
+    };
+    if (mix == "pages") return pages;
+    if (mix == "api") return api;
+    pages.insert(pages.end(), api.begin(), api.end());
+    return pages;
+}
+
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0;
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+class VirtualUser : public std::enable_shared_from_this<VirtualUser> {
+public:
+    VirtualUser(const LoadOptions& options, trantor::EventLoop* loop, const std::vector<Step>& script,
+                std::string username, Clock::time_point measureFrom, Clock::time_point stopAt,
+                std::function<void()> finished)
+        : _client(HttpClient::newHttpClient(options.url, loop)),
+          _script(script),
+          _username(std::move(username)),
+          _measureFrom(measureFrom),
+          _stopAt(stopAt),
+          _finished(std::move(finished)) {
+        _client->enableCookies(true);
+    }
+
+    // Register once if the script logs in, then loop until the deadline
+    void start(bool needsAccount) {
+        if (!needsAccount) {
+            next();
+            return;
+        }
+        send({"POST /api/register", Post, "/api/register", true}, [self = shared_from_this()]() {
+            self->next();
+        });
+    }
+
+    const Samples& samples() const { return _samples; }
+
+private:
+    void next() {
+        if (Clock::now() >= _stopAt) {
+            _finished();
+            return;
+        }
+        const auto& step = _script[_position++ % _script.size()];
+        send(step, [self = shared_from_this()]() { self->next(); });
+    }
+
+    void send(const Step& step, std::function<void()> then) {
+        HttpRequestPtr req;
+        if (step.jsonBody) {
+            Json::Value body;
+            body["username"] = _username;
+            body["email"] = _username + "@load.test";
+            body["password"] = "load-test-password";
+            req = HttpRequest::newHttpJsonRequest(body);
+        } else {
+            req = HttpRequest::newHttpRequest();
+        }
+        req->setMethod(step.method);
+        req->setPath(step.path);
+
+        auto sentAt = Clock::now();
+        _client->sendRequest(req,
+            [this, name = step.name, sentAt, then = std::move(then)](ReqResult result,
+                                                                     const HttpResponsePtr& resp) {
+                if (sentAt >= _measureFrom) {
+                    auto& stats = _samples[name];
+                    if (result != ReqResult::Ok || !resp) {
+                        ++stats.transportErrors;
+                    } else {
+                        stats.latencies.push_back(
+                            std::chrono::duration<double, std::milli>(Clock::now() - sentAt).count());
+                        ++stats.statuses[static_cast<int>(resp->getStatusCode())];
+                    }
+                }
+                then();
+            },
+            10.0);
+    }
+
+    HttpClientPtr _client;
+    const std::vector<Step>& _script;
+    std::string _username;
+    Clock::time_point _measureFrom;
+    Clock::time_point _stopAt;
+    std::function<void()> _finished;
+    size_t _position = 0;
+    Samples _samples;
+};
+
+Json::Value summarize(const EndpointStats& stats, double seconds) {
+    Json::Value json;
+    json["requests"] = static_cast<Json::UInt64>(stats.latencies.size());
+    json["transport_errors"] = static_cast<Json::UInt64>(stats.transportErrors);
+    json["throughput_rps"] = seconds > 0 ? static_cast<double>(stats.latencies.size()) / seconds : 0.0;
+    for (const auto& [status, count] : stats.statuses) {
+        json["status"][std::to_string(status)] = static_cast<Json::UInt64>(count);
+    }
+
+    double sum = 0;
+    for (double latency : stats.latencies) sum += latency;
+    auto& latency = json["latency_ms"];
+    latency["mean"] = stats.latencies.empty() ? 0.0 : sum / static_cast<double>(stats.latencies.size());
+    latency["p50"] = percentile(stats.latencies, 50);
+    latency["p90"] = percentile(stats.latencies, 90);
+    latency["p99"] = percentile(stats.latencies, 99);
+    latency["p999"] = percentile(stats.latencies, 99.9);
+    latency["max"] = stats.latencies.empty() ? 0.0
+                                             : *std::max_element(stats.latencies.begin(), stats.latencies.end());
+    return json;
+}
+
+bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        try {
+            if (arg == "--url") options.url = value;
+            else if (arg == "--concurrency") options.concurrency = std::max<size_t>(1, std::stoul(value));
+            else if (arg == "--duration") options.durationSeconds = std::stod(value);
+            else if (arg == "--warmup") options.warmupSeconds = std::stod(value);
+            else if (arg == "--threads") options.threads = std::max<size_t>(1, std::stoul(value));
+            else if (arg == "--mix") options.mix = value;
+            else if (arg == "--out") options.out = value;
+            else return false;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return options.mix == "all" || options.mix == "pages" || options.mix == "api";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--url URL] [--concurrency N] [--duration S] [--warmup S]"
+                     " [--threads N] [--mix all|pages|api] [--out FILE]" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<trantor::EventLoopThread>> loops;
+    for (size_t i = 0; i < std::min(options.threads, options.concurrency); ++i) {
+        loops.push_back(std::make_unique<trantor::EventLoopThread>("load-" + std::to_string(i)));
+        loops.back()->run();
+    }
+
+    auto script = scriptFor(options.mix);
+    bool needsAccount = options.mix != "pages";
+    std::string runId = std::to_string(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    std::cout << "Load: " << options.concurrency << " virtual users on " << loops.size() << " loop(s), "
+              << options.durationSeconds << " s (+" << options.warmupSeconds << " s warm-up) against "
+              << options.url << ", mix " << options.mix << std::endl;
+
+    auto start = Clock::now();
+    auto measureFrom = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.warmupSeconds));
+    auto stopAt = measureFrom + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options.durationSeconds));
+
+    std::atomic<size_t> running{options.concurrency};
+    std::promise<void> allFinished;
+    std::vector<std::shared_ptr<VirtualUser>> users;
+    for (size_t i = 0; i < options.concurrency; ++i) {
+        auto* loop = loops[i % loops.size()]->getLoop();
+        auto user = std::make_shared<VirtualUser>(
+            options, loop, script, "load_" + runId + "_" + std::to_string(i), measureFrom, stopAt,
+            [&running, &allFinished]() {
+                if (running.fetch_sub(1) == 1) allFinished.set_value();
+            });
+        users.push_back(user);
+        loop->queueInLoop([user, needsAccount]() { user->start(needsAccount); });
+    }
+    allFinished.get_future().wait();
+    double seconds = options.durationSeconds;
+
+    // Loops are idle now; merge per-user samples
+    Samples merged;
+    EndpointStats total;
+    for (const auto& user : users) {
+        for (const auto& [name, stats] : user->samples()) {
+            auto& into = merged[name];
+            into.latencies.insert(into.latencies.end(), stats.latencies.begin(), stats.latencies.end());
+            into.transportErrors += stats.transportErrors;
+            total.latencies.insert(total.latencies.end(), stats.latencies.begin(), stats.latencies.end());
+            total.transportErrors += stats.transportErrors;
+            for (const auto& [status, count] : stats.statuses) {
+                into.statuses[status] += count;
+                total.statuses[status] += count;
+            }
+        }
+    }
+
+    Json::Value report;
+    report["url"] = options.url;
+    report["mix"] = options.mix;
+    report["concurrency"] = static_cast<Json::UInt64>(options.concurrency);
+    report["duration_s"] = seconds;
+    report["warmup_s"] = options.warmupSeconds;
+    report["total"] = summarize(total, seconds);
+
+    std::cout << std::left << std::setw(22) << "endpoint" << std::right
+              << std::setw(10) << "req/s" << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::setw(10) << "errors" << std::endl;
+    auto printRow = [](const std::string& name, const Json::Value& json) {
+        size_t errors = json["transport_errors"].asUInt64();
+        for (const auto& status : json["status"].getMemberNames()) {
+            if (std::stoi(status) >= 400) errors += json["status"][status].asUInt64();
+        }
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << json["throughput_rps"].asDouble()
+                  << std::setprecision(2)
+                  << std::setw(10) << json["latency_ms"]["p50"].asDouble()
+                  << std::setw(10) << json["latency_ms"]["p90"].asDouble()
+                  << std::setw(10) << json["latency_ms"]["p99"].asDouble()
+                  << std::setw(10) << json["latency_ms"]["max"].asDouble()
+                  << std::setw(10) << errors << std::endl;
+    };
+    for (const auto& [name, stats] : merged) {
+        report["endpoints"][name] = summarize(stats, seconds);
+        printRow(name, report["endpoints"][name]);
+    }
+    printRow("total", report["total"]);
+
+    std::ofstream file(options.out, std::ios::trunc);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    file << Json::writeString(builder, report) << std::endl;
+    if (!file) {
+        std::cerr << "Cannot write " << options.out << std::endl;
+        return 1;
+    }
+    std::cout << "Results written to " << options.out << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+// RegisterBatcherBench.cpp - signup burst: one INSERT per request vs coalesced multi-row INSERTs
+//
+// Needs a local, throwaway PostgreSQL database in DROGON_BENCH_PG (see StatementBench.cpp).
+// Rows created by the scenario are deleted afterwards.
+#include "Bench.h"
+#include "RegisterBatcher.h"
+#include <drogon/orm/DbClient.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace drogon::orm;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kSignups = 5000;
+constexpr size_t kProducers = 8;
+constexpr size_t kDuplicateEvery = 50;    // Every 50th signup reuses a taken username
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void runBurst(const std::shared_ptr<DbClient>& client, const char* label, const Json::Value& config) {
+    auto& batcher = RegisterBatcher::getInstance();
+    batcher.start(config, [client]() { return client; });
+    client->execSqlSync("DELETE FROM users WHERE username LIKE 'bench_reg_%'");
+
+    std::mutex mutex;
+    std::vector<double> latencies;
+    latencies.reserve(kSignups);
+    std::atomic<size_t> created{0};
+    std::atomic<size_t> conflicts{0};
+    std::atomic<size_t> remaining{kSignups};
+    std::promise<void> finished;
+    uint64_t batchesBefore = batcher.batches();
+
+    auto benchStart = Clock::now();
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (size_t i = p; i < kSignups; i += kProducers) {
+                size_t n = (i % kDuplicateEvery == kDuplicateEvery - 1) ? i - 1 : i;
+                std::string name = "bench_reg_" + std::to_string(n);
+                auto start = Clock::now();
+                batcher.submit(
+                    nullptr,
+                    {name, name + "@bench.local", std::string(64, '0')},
+                    [&, start](RegisterBatcher::Outcome outcome) {
+                        double latency = millisSince(start);
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            latencies.push_back(latency);
+                        }
+                        if (outcome.status == RegisterBatcher::Status::kCreated) ++created;
+                        if (outcome.status == RegisterBatcher::Status::kConflict) ++conflicts;
+                        if (remaining.fetch_sub(1) == 1) finished.set_value();
+                    });
+            }
+        });
+    }
+
+    for (auto& producer : producers) producer.join();
+    finished.get_future().wait();
+    double totalSeconds = millisSince(benchStart) / 1000.0;
+
+    std::cout << std::fixed << std::setprecision(2) << label
+              << "  " << static_cast<double>(kSignups) / totalSeconds << " signups/s"
+              << "  p50 " << bench::percentile(latencies, 50) << " ms"
+              << "  p99 " << bench::percentile(latencies, 99) << " ms"
+              << "  inserts " << batcher.batches() - batchesBefore
+              << "  created " << created.load() << "  conflicts " << conflicts.load()
+              << std::endl;
+}
+
+}
+
+BENCH_SCENARIO("register_batcher/signup_burst", []() {
+    const char* connInfo = std::getenv("DROGON_BENCH_PG");
+    if (!connInfo) {
+        std::cout << "skipped: set DROGON_BENCH_PG to a local PostgreSQL connection string" << std::endl;
+        return;
+    }
+
+    // One connection, the pool size the app defaults to
+    auto client = DbClient::newPgClient(connInfo, 1);
+    try {
+        client->execSqlSync(
+            "CREATE TABLE IF NOT EXISTS users ("
+            "id SERIAL PRIMARY KEY, username VARCHAR(50) UNIQUE NOT NULL, "
+            "email VARCHAR(100) UNIQUE NOT NULL, password_hash VARCHAR(255) NOT NULL)");
+    } catch (const DrogonDbException& e) {
+        std::cout << "skipped: " << e.base().what() << std::endl;
+        return;
+    }
+
+    Json::Value single;
+    single["enabled"] = false;
+    runBurst(client, "one insert per signup", single);
+
+    for (double windowMs : {1.0, 5.0}) {
+        Json::Value batched;
+        batched["enabled"] = true;
+        batched["max_batch"] = 64;
+        batched["window_ms"] = windowMs;
+        std::string label = "batched, " + std::to_string(static_cast<int>(windowMs)) + " ms window";
+        runBurst(client, label.c_str(), batched);
+    }
+
+    client->execSqlSync("DELETE FROM users WHERE username LIKE 'bench_reg_%'");
+});
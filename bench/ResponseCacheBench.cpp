@@ -0,0 +1,111 @@
+// ResponseCacheBench.cpp - cached page responses vs building (and compressing) them per request
+#include "Bench.h"
+#include "ResponseCache.h"
+#include <drogon/utils/Utilities.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+constexpr size_t kMissThreads = 8;
+
+// ~20 KB of page markup, about the size of the home view with its inlined rewrites
+const std::string& pageBody() {
+    static const std::string body = []() {
+        std::string html = "<!DOCTYPE html><html><head><title>Home</title></head><body>";
+        for (int i = 0; html.size() < 20000; ++i) {
+            html += "<div class=\"card\"><h5 class=\"card-title\">Item " + std::to_string(i) +
+                    "</h5><p class=\"card-text\">Lorem ipsum dolor sit amet.</p></div>\n";
+        }
+        return html + "</body></html>";
+    }();
+    return body;
+}
+
+void buildPage(std::function<void(ResponseCache::Content)> done) {
+    done({drogon::k200OK, drogon::CT_TEXT_HTML, pageBody()});
+}
+
+void configureCache() {
+    static const bool configured = []() {
+        Json::Value config;
+        config["routes"]["/bench"]["ttl_ms"] = 3600000;
+        config["routes"]["/bench/coalesce"]["ttl_ms"] = 3600000;
+        ResponseCache::getInstance().configure(config);
+        return true;
+    }();
+    (void)configured;
+}
+
+drogon::HttpRequestPtr pageRequest(const std::string& acceptEncoding) {
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setMethod(drogon::Get);
+    req->setPath("/");
+    if (!acceptEncoding.empty()) req->addHeader("Accept-Encoding", acceptEncoding);
+    return req;
+}
+
+void serveCached(const std::string& acceptEncoding, size_t n) {
+    configureCache();
+    auto req = pageRequest(acceptEncoding);
+    for (size_t i = 0; i < n; ++i) {
+        ResponseCache::getInstance().serve(req, "/bench", {}, buildPage,
+            [](const drogon::HttpResponsePtr& resp) { bench::escape(resp.get()); });
+    }
+}
+
+}
+
+BENCHMARK("response_cache/hit/identity", [](size_t n) {
+    serveCached("", n);
+});
+
+BENCHMARK("response_cache/hit/br_gzip", [](size_t n) {
+    serveCached("gzip, deflate, br", n);
+});
+
+// What the page handlers cost without the cache: a new response per request,
+// which drogon then gzips on the way out
+BENCHMARK("response_cache/uncached/build_and_gzip", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setContentTypeCode(drogon::CT_TEXT_HTML);
+        resp->setBody(pageBody());
+        auto compressed = drogon::utils::gzipCompress(pageBody().data(), pageBody().size());
+        bench::escape(resp.get());
+        bench::escape(compressed.data());
+    }
+});
+
+// Concurrent misses on a cold entry: one slow build, everyone else waits for it
+BENCH_SCENARIO("response_cache/coalesced_misses", []() {
+    configureCache();
+    auto& cache = ResponseCache::getInstance();
+    uint64_t buildsBefore = cache.builds();
+    uint64_t coalescedBefore = cache.coalesced();
+
+    std::atomic<size_t> answered{0};
+    auto slowBuild = [](std::function<void(ResponseCache::Content)> done) {
+        std::thread([done = std::move(done)]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            buildPage(done);
+        }).detach();
+    };
+
+    std::vector<std::thread> clients;
+    for (size_t t = 0; t < kMissThreads; ++t) {
+        clients.emplace_back([&]() {
+            auto req = pageRequest("gzip");
+            cache.serve(req, "/bench/coalesce", {}, slowBuild,
+                        [&answered](const drogon::HttpResponsePtr&) { ++answered; });
+        });
+    }
+    for (auto& client : clients) client.join();
+    while (answered.load() < kMissThreads) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::cout << kMissThreads << " concurrent misses: " << cache.builds() - buildsBefore << " build(s), "
+              << cache.coalesced() - coalescedBefore << " coalesced, " << answered.load() << " answered"
+              << std::endl;
+});
@@ -0,0 +1,68 @@
+// RoutePolicyBench.cpp - compiled RoutePolicy against the original AuthFilter scan
+#include "Bench.h"
+#include "RoutePolicy.h"
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> kPaths = {
+    "/api/login", "/api/me", "/css/bootstrap.min.css", "/", "/dashboard/settings",
+    "/api/v1/users", "/fonts/bootstrap-icons.woff2", "/login",
+};
+
+// Public-route check from the original AuthFilter::doFilter
+bool legacyIsPublic(const std::string& path) {
+    std::vector<std::string> publicRoutes = {
+        "/api/login",
+        "/api/register",
+        "/",
+        "/login.html",
+        "/register.html",
+        "/css/",
+        "/js/",
+        "/fonts/"
+    };
+
+    bool isPublic = false;
+    for (const auto& route : publicRoutes) {
+        if (path.find(route) == 0) {
+            isPublic = true;
+            break;
+        }
+    }
+    return isPublic;
+}
+
+}
+
+BENCHMARK("auth_filter/route_check/legacy_vector_scan", [](size_t n) {
+    size_t publicCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        publicCount += legacyIsPublic(kPaths[i % kPaths.size()]);
+    }
+    bench::escape(&publicCount);
+});
+
+BENCHMARK("auth_filter/route_check/compiled_policy", [](size_t n) {
+    const auto& policy = RoutePolicy::getInstance();
+    size_t publicCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        publicCount += policy.decide(kPaths[i % kPaths.size()]) == RoutePolicy::Decision::Public;
+    }
+    bench::escape(&publicCount);
+});
+
+BENCHMARK("auth_filter/route_check/compiled_policy_glob", [](size_t n) {
+    static RoutePolicy policy = [] {
+        RoutePolicy p;
+        auto rules = RoutePolicy::defaultRules();
+        rules.push_back({"/api/v*/users", RoutePolicy::Match::Glob, RoutePolicy::Decision::Authenticated});
+        p.load(rules, RoutePolicy::Decision::Authenticated);
+        return p;
+    }();
+    size_t publicCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        publicCount += policy.decide(kPaths[i % kPaths.size()]) == RoutePolicy::Decision::Public;
+    }
+    bench::escape(&publicCount);
+});
@@ -0,0 +1,201 @@
+// SessionStoreBench.cpp - authenticated AuthFilter and session lookups with 1M live sessions
+//
+// The baseline models drogon's built-in store: one mutex-guarded map keyed by the
+// session id string, each session a shared map of std::any values.
+#include "Bench.h"
+#include "AuthFilter.h"
+#include "SessionStore.h"
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kLiveSessions = 1000000;
+constexpr size_t kProbeIds = 4096;          // Sessions the benchmarks look up, spread over the store
+constexpr size_t kThreads = 8;
+constexpr size_t kLookupsPerThread = 500000;
+
+// 1M sessions in the global SessionStore, plus a sample of their ids
+const std::vector<SessionId>& liveSessions() {
+    static const std::vector<SessionId> probes = []() {
+        auto& store = SessionStore::getInstance();
+        Json::Value config;
+        config["shards"] = 64;
+        config["idle_timeout_seconds"] = 3600;
+        store.configure(config);
+
+        std::vector<SessionId> sample;
+        sample.reserve(kProbeIds);
+        auto start = Clock::now();
+        for (size_t i = 0; i < kLiveSessions; ++i) {
+            auto id = SessionId::generate();
+            SessionData data;
+            data.userId = static_cast<int>(i);
+            data.setUsername("bench_user_" + std::to_string(i));
+            store.backend().put(id, data);
+            if (i % (kLiveSessions / kProbeIds) == 0 && sample.size() < kProbeIds) sample.push_back(id);
+        }
+        std::cout << "(filled " << store.size() << " sessions in "
+                  << std::chrono::duration<double>(Clock::now() - start).count() << " s)" << std::endl;
+        return sample;
+    }();
+    return probes;
+}
+
+// drogon-style store: string keys, one lock, a map of std::any per session
+class LegacySessionStore {
+public:
+    struct Session {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::any> values;
+    };
+
+    void put(const std::string& id, int userId, const std::string& username) {
+        auto session = std::make_shared<Session>();
+        session->values["user_id"] = userId;
+        session->values["username"] = username;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sessions[id] = std::move(session);
+    }
+
+    bool findUserId(const std::string& id, int& userId) {
+        std::shared_ptr<Session> session;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _sessions.find(id);
+            if (it == _sessions.end()) return false;
+            session = it->second;
+        }
+        std::lock_guard<std::mutex> lock(session->mutex);
+        auto it = session->values.find("user_id");
+        if (it == session->values.end()) return false;
+        userId = std::any_cast<int>(it->second);
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::shared_ptr<Session>> _sessions;
+};
+
+struct LegacyFixture {
+    LegacySessionStore store;
+    std::vector<std::string> probes;
+};
+
+LegacyFixture& legacySessions() {
+    static LegacyFixture fixture;
+    static const bool filled = []() {
+        for (size_t i = 0; i < kLiveSessions; ++i) {
+            auto id = SessionId::generate().toString();
+            fixture.store.put(id, static_cast<int>(i), "bench_user_" + std::to_string(i));
+            if (i % (kLiveSessions / kProbeIds) == 0 && fixture.probes.size() < kProbeIds) {
+                fixture.probes.push_back(id);
+            }
+        }
+        return true;
+    }();
+    (void)filled;
+    return fixture;
+}
+
+std::vector<drogon::HttpRequestPtr> authenticatedRequests() {
+    std::vector<drogon::HttpRequestPtr> requests;
+    for (const auto& id : liveSessions()) {
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setMethod(drogon::Get);
+        req->setPath("/api/v1/users");
+        req->addCookie("sid", id.toString());
+        requests.push_back(req);
+    }
+    return requests;
+}
+
+// Run `lookup` from kThreads threads at once and print the aggregate rate
+void runContended(const char* label, const std::function<bool(size_t)>& lookup) {
+    std::atomic<size_t> hits{0};
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            size_t local = 0;
+            for (size_t i = 0; i < kLookupsPerThread; ++i) {
+                local += lookup(t * 7919 + i);
+            }
+            hits += local;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << std::left << std::setw(28) << label << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << static_cast<double>(kThreads * kLookupsPerThread) / seconds / 1e6
+              << " M lookups/s  (" << kThreads << " threads, " << hits.load() << " hits)" << std::endl;
+}
+
+}
+
+BENCHMARK("session_store/auth_filter/1m_sessions", [](size_t n) {
+    static const auto requests = authenticatedRequests();
+    AuthFilter filter;
+    size_t passed = 0;
+    for (size_t i = 0; i < n; ++i) {
+        filter.doFilter(requests[i % requests.size()],
+                        [](const drogon::HttpResponsePtr& resp) { bench::escape(resp.get()); },
+                        [&passed]() { ++passed; });
+    }
+    bench::escape(&passed);
+});
+
+BENCHMARK("session_store/get/sharded_1m", [](size_t n) {
+    const auto& probes = liveSessions();
+    auto& backend = SessionStore::getInstance().backend();
+    SessionData data;
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        hits += backend.get(probes[i % probes.size()], data);
+    }
+    bench::escape(&hits);
+});
+
+BENCHMARK("session_store/get/single_lock_map_1m", [](size_t n) {
+    auto& legacy = legacySessions();
+    int userId = 0;
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        hits += legacy.store.findUserId(legacy.probes[i % legacy.probes.size()], userId);
+    }
+    bench::escape(&hits);
+});
+
+// A tick with nothing due: cost depends on the shard count, not on 1M sessions
+BENCHMARK("session_store/tick/1m_sessions", [](size_t n) {
+    liveSessions();
+    for (size_t i = 0; i < n; ++i) {
+        SessionStore::getInstance().tick();
+    }
+});
+
+BENCH_SCENARIO("session_store/contended_lookups_1m", []() {
+    const auto& probes = liveSessions();
+    auto& backend = SessionStore::getInstance().backend();
+    runContended("sharded (64 shards)", [&](size_t i) {
+        SessionData data;
+        return backend.get(probes[i % probes.size()], data);
+    });
+
+    auto& legacy = legacySessions();
+    runContended("single lock + std::any", [&](size_t i) {
+        int userId = 0;
+        return legacy.store.findUserId(legacy.probes[i % legacy.probes.size()], userId);
+    });
+});
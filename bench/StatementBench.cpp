@@ -0,0 +1,119 @@
+// StatementBench.cpp - login lookup throughput: the inline parameterized call vs StatementRegistry
+//
+// Both send the same $1 text, which drogon prepares once per connection, so no
+// planning difference is expected; the numbers show what the registry's timing
+// and tracing wrapper costs on top of the plain call.
+//
+// Needs a local, throwaway PostgreSQL database:
+//   DROGON_BENCH_PG="host=127.0.0.1 port=5432 dbname=bench user=postgres password=postgres sslmode=disable"
+// The scenario creates the users table if it is missing and inserts one bench user.
+#include "Bench.h"
+#include "Metrics.h"
+#include "StatementRegistry.h"
+#include <drogon/orm/DbClient.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+using namespace drogon::orm;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kConnections = 4;
+constexpr size_t kLookups = 20000;
+constexpr size_t kInFlight = 64;          // Concurrent lookups, like many IO threads logging in
+const char* kBenchUser = "bench_login_user";
+
+double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Issue kLookups lookups keeping kInFlight outstanding; `lookup` runs one and calls done
+void runLookups(const char* label,
+                const std::function<void(std::function<void()>)>& lookup) {
+    std::mutex mutex;
+    std::vector<double> latencies;
+    latencies.reserve(kLookups);
+    std::atomic<size_t> issued{0};
+    std::atomic<size_t> remaining{kLookups};
+    std::promise<void> finished;
+
+    std::function<void()> next = [&]() {
+        if (issued.fetch_add(1) >= kLookups) return;
+        auto start = Clock::now();
+        lookup([&, start]() {
+            double latency = millisSince(start);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                latencies.push_back(latency);
+            }
+            if (remaining.fetch_sub(1) == 1) {
+                finished.set_value();
+                return;
+            }
+            next();
+        });
+    };
+
+    auto benchStart = Clock::now();
+    for (size_t i = 0; i < kInFlight; ++i) next();
+    finished.get_future().wait();
+    double totalSeconds = millisSince(benchStart) / 1000.0;
+
+    std::cout << std::fixed << std::setprecision(2) << label
+              << "  p50 " << bench::percentile(latencies, 50) << " ms"
+              << "  p99 " << bench::percentile(latencies, 99) << " ms"
+              << "  throughput " << static_cast<double>(kLookups) / totalSeconds << " lookups/s"
+              << std::endl;
+}
+
+}
+
+BENCH_SCENARIO("statements/login_lookup_throughput", []() {
+    const char* connInfo = std::getenv("DROGON_BENCH_PG");
+    if (!connInfo) {
+        std::cout << "skipped: set DROGON_BENCH_PG to a local PostgreSQL connection string" << std::endl;
+        return;
+    }
+
+    auto client = DbClient::newPgClient(connInfo, kConnections);
+    try {
+        client->execSqlSync(
+            "CREATE TABLE IF NOT EXISTS users ("
+            "id SERIAL PRIMARY KEY, username VARCHAR(50) UNIQUE NOT NULL, "
+            "email VARCHAR(100) UNIQUE NOT NULL, password_hash VARCHAR(255) NOT NULL)");
+        client->execSqlSync(
+            "INSERT INTO users (username, email, password_hash) VALUES ($1, $2, $3) "
+            "ON CONFLICT DO NOTHING",
+            std::string(kBenchUser), std::string(kBenchUser) + "@bench.local", std::string(64, '0'));
+    } catch (const DrogonDbException& e) {
+        std::cout << "skipped: " << e.base().what() << std::endl;
+        return;
+    }
+
+    // Before: the call AuthController made inline, with its own timer
+    runLookups("inline    ", [&](std::function<void()> done) {
+        auto timer = Metrics::startQuery(Metrics::kQueryLoginLookup);
+        client->execSqlAsync(
+            "SELECT id, username, email, password_hash FROM users WHERE username = $1 OR email = $1",
+            [done, timer](const Result& r) { timer.done(true); bench::escape(&r); done(); },
+            [done, timer](const DrogonDbException&) { timer.done(false); done(); },
+            std::string(kBenchUser));
+    });
+
+    // After: the registered statement, same text
+    runLookups("registered", [&](std::function<void()> done) {
+        StatementRegistry::exec(
+            client,
+            StatementRegistry::kFindUserByLogin,
+            [done](const Result& r) { bench::escape(&r); done(); },
+            [done](const DrogonDbException&) { done(); },
+            std::string(kBenchUser));
+    });
+});
@@ -0,0 +1,85 @@
+// TemplateBench.cpp - ViewTemplate against the old find/replace substitution
+#include "Bench.h"
+#include "ViewLoader.h"
+#include "ViewTemplate.h"
+#include <iostream>
+
+namespace {
+
+// home.html (11 KB) with a {{NAME}} slot in place of every `needle`
+std::string homeFixture(const std::string& needle, const std::string& slot) {
+    std::string html;
+    try {
+        html = ViewLoader::loadView("home");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return html;
+    }
+
+    std::string out;
+    size_t pos = 0, last = 0;
+    while ((pos = html.find(needle, last)) != std::string::npos) {
+        out.append(html, last, pos - last);
+        out += slot;
+        last = pos + needle.size();
+    }
+    out.append(html, last, std::string::npos);
+    return out;
+}
+
+// Substitution loop from the original ViewLoader::loadViewWithData
+std::string legacyReplace(std::string html, const std::string& placeholder, const std::string& value) {
+    std::string search = "{{" + placeholder + "}}";
+    size_t pos = 0;
+    while ((pos = html.find(search, pos)) != std::string::npos) {
+        html.replace(pos, search.length(), value);
+        pos += value.length();
+    }
+    return html;
+}
+
+const std::string kValue = "Visitor <guest@example.com>";
+
+// 4 slots: every "Drogon" in the page
+const std::string& sparsePage() {
+    static const std::string page = homeFixture("Drogon", "{{NAME}}");
+    return page;
+}
+
+// ~100 slots: one before every class attribute
+const std::string& densePage() {
+    static const std::string page = homeFixture("class=", "{{NAME}} class=");
+    return page;
+}
+
+void legacy(const std::string& page, size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+        auto html = legacyReplace(page, "NAME", kValue);
+        bench::escape(html.data());
+    }
+}
+
+void compiled(const std::string& page, size_t iterations) {
+    static const ViewTemplate sparse = ViewTemplate::compile(sparsePage());
+    static const ViewTemplate dense = ViewTemplate::compile(densePage());
+    const ViewTemplate& view = &page == &sparsePage() ? sparse : dense;
+
+    std::vector<std::string_view> values{kValue};
+    for (size_t i = 0; i < iterations; ++i) {
+        auto html = view.render(values);
+        bench::escape(html.data());
+    }
+}
+
+}
+
+BENCHMARK("template/home_4_slots/legacy_replace", [](size_t n) { legacy(sparsePage(), n); });
+BENCHMARK("template/home_4_slots/compiled", [](size_t n) { compiled(sparsePage(), n); });
+BENCHMARK("template/home_106_slots/legacy_replace", [](size_t n) { legacy(densePage(), n); });
+BENCHMARK("template/home_106_slots/compiled", [](size_t n) { compiled(densePage(), n); });
+BENCHMARK("template/home/compile", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto view = ViewTemplate::compile(sparsePage());
+        bench::escape(&view);
+    }
+});
@@ -0,0 +1,132 @@
+// TokenAuthBench.cpp - signed-token issue/verify, and AuthFilter in token mode vs session mode
+#include "Bench.h"
+#include "AuthFilter.h"
+#include "SessionStore.h"
+#include "TokenAuth.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kFilterIterations = 1000000;
+constexpr size_t kThreads = 8;
+
+Json::Value tokenConfig(bool enabled) {
+    Json::Value key;
+    key["id"] = 7;
+    key["secret"] = "bench-secret-bench-secret-bench-secret-0123456789";
+    Json::Value config;
+    config["enabled"] = enabled;
+    config["signing_key"] = 7;
+    config["keys"].append(key);
+    return config;
+}
+
+SessionData benchClaims() {
+    SessionData claims;
+    claims.userId = 424242;
+    claims.setUsername("bench_user_424242");
+    return claims;
+}
+
+const std::string& benchToken() {
+    static const std::string token = []() {
+        TokenAuth::getInstance().configure(tokenConfig(false));
+        return TokenAuth::getInstance().issue(benchClaims());
+    }();
+    return token;
+}
+
+drogon::HttpRequestPtr requestWithCookie(const std::string& name, const std::string& value) {
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setMethod(drogon::Get);
+    req->setPath("/api/v1/users");
+    req->addCookie(name, value);
+    return req;
+}
+
+// Time AuthFilter::doFilter on req from `threads` threads; returns ns per request per thread
+double timeFilter(const drogon::HttpRequestPtr& req, size_t threads) {
+    std::atomic<size_t> passed{0};
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            AuthFilter filter;
+            size_t local = 0;
+            for (size_t i = 0; i < kFilterIterations / threads; ++i) {
+                filter.doFilter(req,
+                                [](const drogon::HttpResponsePtr& resp) { bench::escape(resp.get()); },
+                                [&local]() { ++local; });
+            }
+            passed += local;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (passed.load() != (kFilterIterations / threads) * threads) {
+        std::cout << "  (warning: only " << passed.load() << " requests authenticated)" << std::endl;
+    }
+    return ns * static_cast<double>(threads) / static_cast<double>(kFilterIterations);
+}
+
+}
+
+BENCHMARK("token_auth/issue", [](size_t n) {
+    benchToken();
+    auto claims = benchClaims();
+    for (size_t i = 0; i < n; ++i) {
+        auto token = TokenAuth::getInstance().issue(claims);
+        bench::escape(token.data());
+    }
+});
+
+BENCHMARK("token_auth/verify/valid", [](size_t n) {
+    const auto& token = benchToken();
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        valid += TokenAuth::getInstance().verify(token).has_value();
+    }
+    bench::escape(&valid);
+});
+
+// Same length as a real token, last MAC character changed: full MAC cost, then reject
+BENCHMARK("token_auth/verify/forged", [](size_t n) {
+    static const std::string forged = []() {
+        std::string token = benchToken();
+        token.back() = token.back() == 'A' ? 'B' : 'A';
+        return token;
+    }();
+    size_t valid = 0;
+    for (size_t i = 0; i < n; ++i) {
+        valid += TokenAuth::getInstance().verify(forged).has_value();
+    }
+    bench::escape(&valid);
+});
+
+BENCH_SCENARIO("token_auth/auth_filter_token_vs_session", []() {
+    auto& tokens = TokenAuth::getInstance();
+    auto tokenRequest = requestWithCookie("auth_token", benchToken());
+
+    auto& sessions = SessionStore::getInstance();
+    auto id = SessionId::generate();
+    sessions.backend().put(id, benchClaims());
+    auto sessionRequest = requestWithCookie("sid", id.toString());
+
+    std::cout << "live sessions: " << sessions.size() << std::endl;
+    std::cout << std::left << std::setw(12) << "threads" << std::right << std::setw(16) << "token ns/req"
+              << std::setw(18) << "session ns/req" << std::endl;
+    for (size_t threads : {size_t(1), kThreads}) {
+        tokens.configure(tokenConfig(true));
+        double tokenNs = timeFilter(tokenRequest, threads);
+        tokens.configure(tokenConfig(false));
+        double sessionNs = timeFilter(sessionRequest, threads);
+        std::cout << std::left << std::setw(12) << threads << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << tokenNs << std::setw(18) << sessionNs << std::endl;
+    }
+});
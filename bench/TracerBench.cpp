@@ -0,0 +1,43 @@
+// TracerBench.cpp - cost of a span on the request path, unsampled vs sampled
+#include "Bench.h"
+#include "Tracer.h"
+#include <cstdio>
+
+namespace {
+
+// Tracing on, nothing sampled by rate; the file goes to the temp directory
+void installTracer() {
+    static const bool installed = []() {
+        Json::Value config;
+        config["enabled"] = true;
+        config["sample_rate"] = 0.0;
+        config["output"] = std::string(P_tmpdir) + "/drogonapp_bench_trace.json";
+        config["ring_events"] = 1 << 16;
+        config["flush_ms"] = 10;
+        Tracer::getInstance().configure(config);
+        Tracer::getInstance().install();
+        return true;
+    }();
+    (void)installed;
+}
+
+}
+
+// What every unsampled request pays per instrumented call site
+BENCHMARK("tracer/span/unsampled", [](size_t n) {
+    installTracer();
+    Tracer::ContextScope scope(0);
+    for (size_t i = 0; i < n; ++i) {
+        Tracer::Span span("serialize", "json");
+        bench::escape(&span);
+    }
+});
+
+BENCHMARK("tracer/span/sampled", [](size_t n) {
+    installTracer();
+    Tracer::ContextScope scope(1);
+    for (size_t i = 0; i < n; ++i) {
+        Tracer::Span span("serialize", "json");
+        bench::escape(&span);
+    }
+});
@@ -0,0 +1,39 @@
+// UserBench.cpp - User model conversions to and from Json::Value
+#include "Bench.h"
+#include "User.h"
+
+namespace {
+
+const User kUser(42, "bench_user", "bench.user@example.com");
+
+Json::Value userJson() {
+    Json::Value json;
+    json["id"] = 42;
+    json["username"] = "bench_user";
+    json["email"] = "bench.user@example.com";
+    return json;
+}
+
+}
+
+BENCHMARK("user/to_json", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto json = kUser.toJson();
+        bench::escape(&json);
+    }
+});
+
+BENCHMARK("user/from_json", [](size_t n) {
+    const auto json = userJson();
+    for (size_t i = 0; i < n; ++i) {
+        auto user = User::fromJson(json);
+        bench::escape(&user);
+    }
+});
+
+BENCHMARK("user/round_trip", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto user = User::fromJson(kUser.toJson());
+        bench::escape(&user);
+    }
+});
@@ -0,0 +1,31 @@
+// ViewLoaderBench.cpp - reading views from disk on every request vs the startup lookup
+#include "Bench.h"
+#include "ViewLoader.h"
+
+BENCHMARK("view_loader/views_directory", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        bench::escape(&ViewLoader::viewsDirectory());
+    }
+});
+
+BENCHMARK("view_loader/load_view/home", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto html = ViewLoader::loadView("home");
+        bench::escape(html.data());
+    }
+});
+
+BENCHMARK("view_loader/load_view/login", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto html = ViewLoader::loadView("login");
+        bench::escape(html.data());
+    }
+});
+
+// Read + compile + render of one slot, as the greeting page did per request
+BENCHMARK("view_loader/load_view_with_data/home", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        auto html = ViewLoader::loadViewWithData("home", "USERNAME", "bench_user");
+        bench::escape(html.data());
+    }
+});
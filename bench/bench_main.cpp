@@ -0,0 +1,147 @@
+// bench_main.cpp
+#include "Bench.h"
+#include <json/json.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace bench {
+
+namespace {
+
+std::vector<std::pair<std::string, BenchFunction>>& registry() {
+    static std::vector<std::pair<std::string, BenchFunction>> benchmarks;
+    return benchmarks;
+}
+
+std::vector<std::pair<std::string, std::function<void()>>>& scenarios() {
+    static std::vector<std::pair<std::string, std::function<void()>>> list;
+    return list;
+}
+
+// Grow the iteration count until one run takes at least this long
+constexpr std::chrono::milliseconds kMinRunTime(200);
+
+}
+
+int registerBenchmark(const std::string& name, BenchFunction fn) {
+    registry().emplace_back(name, std::move(fn));
+    return static_cast<int>(registry().size());
+}
+
+int registerScenario(const std::string& name, std::function<void()> fn) {
+    scenarios().emplace_back(name, std::move(fn));
+    return static_cast<int>(scenarios().size());
+}
+
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0;
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+std::vector<Result> runAll(const std::string& filter) {
+    std::vector<Result> results;
+
+    for (const auto& [name, fn] : registry()) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+        fn(1); // Warm up caches and lazy statics
+
+        size_t iterations = 1;
+        std::chrono::nanoseconds elapsed(0);
+        while (true) {
+            auto start = std::chrono::steady_clock::now();
+            fn(iterations);
+            elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed >= kMinRunTime || iterations >= (size_t(1) << 30)) break;
+            iterations *= elapsed.count() > 0
+                ? std::clamp<size_t>(static_cast<size_t>(kMinRunTime / elapsed) + 1, 2, 100)
+                : 100;
+        }
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nsPerOp = static_cast<double>(elapsed.count()) / iterations;
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(48) << name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << result.nsPerOp << " ns/op"
+                  << std::setw(12) << iterations << " iters" << std::endl;
+    }
+
+    for (const auto& [name, fn] : scenarios()) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+
+        std::cout << "--- " << name << std::endl;
+        fn();
+
+        Result result;
+        result.name = name;
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+}
+
+namespace {
+
+// Microbenchmark results for regression tracking; scenarios print their own reports
+bool writeJsonReport(const std::string& path, const std::vector<bench::Result>& results) {
+    Json::Value report;
+    report["benchmarks"] = Json::Value(Json::arrayValue);
+    for (const auto& result : results) {
+        if (result.iterations == 0) continue;
+        Json::Value entry;
+        entry["name"] = result.name;
+        entry["iterations"] = static_cast<Json::UInt64>(result.iterations);
+        entry["ns_per_op"] = result.nsPerOp;
+        report["benchmarks"].append(entry);
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    file << Json::writeString(builder, report) << std::endl;
+    return static_cast<bool>(file);
+}
+
+}
+
+// Usage: DrogonApp_bench [name-filter] [--json <file>]
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            filter = arg;
+        }
+    }
+
+    std::cout << "==========================================" << std::endl;
+    std::cout << "DrogonApp benchmarks" << (filter.empty() ? "" : " (filter: " + filter + ")") << std::endl;
+    std::cout << "==========================================" << std::endl;
+
+    auto results = bench::runAll(filter);
+    if (results.empty()) {
+        std::cerr << "No benchmark matched" << std::endl;
+        return 1;
+    }
+    if (!jsonPath.empty()) {
+        if (!writeJsonReport(jsonPath, results)) {
+            std::cerr << "Cannot write " << jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << jsonPath << std::endl;
+    }
+    return 0;
+}
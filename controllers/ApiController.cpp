@@ -0,0 +1,341 @@
+#include "ApiController.h"
+#include "DatabaseConfig.h"
+#include "ResponseCache.h"
+#include "StatementRegistry.h"
+#include "User.h"
+#include "UserImport.h"
+#include <drogon/utils/Utilities.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include <trantor/net/TcpConnection.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+using namespace drogon::orm;
+
+namespace {
+
+// Imports currently running on the import loops
+std::atomic<unsigned> runningImports{0};
+
+// Imports block on libpq and hashing, so they run on loops of their own, created on
+// first use and joined at exit rather than a detached thread per request
+trantor::EventLoop* importLoop(size_t threads) {
+    static trantor::EventLoopThreadPool pool(std::max<size_t>(1, threads), "user-import");
+    static std::once_flag started;
+    std::call_once(started, []() { pool.start(); });
+    return pool.getNextLoop();
+}
+
+HttpResponsePtr errorResponse(HttpStatusCode status, const std::string& message) {
+    Json::Value respJson;
+    respJson["error"] = message;
+    auto resp = HttpResponse::newHttpJsonResponse(respJson);
+    resp->setStatusCode(status);
+    return resp;
+}
+
+bool hasPrefix(const std::string& value, const char* prefix) {
+    return value.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+constexpr int kDefaultPageSize = 50;
+constexpr int kMaxPageSize = 500;
+constexpr int kExportPageSize = 1000;
+
+// Cursors are opaque to clients: base64url("u1:<last id>")
+std::string encodeCursor(int lastId) {
+    return drogon::utils::base64Encode("u1:" + std::to_string(lastId), true, false);
+}
+
+bool decodeCursor(const std::string& cursor, int& lastId) {
+    auto decoded = drogon::utils::base64Decode(cursor);
+    if (decoded.compare(0, 3, "u1:") != 0 || decoded.size() == 3) return false;
+    try {
+        size_t used = 0;
+        lastId = std::stoi(decoded.substr(3), &used);
+        return used == decoded.size() - 3 && lastId >= 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::string compactJson(const Json::Value& json) {
+    static const Json::StreamWriterBuilder builder = []() {
+        Json::StreamWriterBuilder b;
+        b["indentation"] = "";
+        return b;
+    }();
+    return Json::writeString(builder, json);
+}
+
+// Full export: keyset pages pushed onto the response stream from the connection's
+// loop. The next page is queried only once the bytes still unsent on the connection
+// are under kExportMaxUnsentBytes, so a slow client slows the export down instead of
+// piling the table up in its write buffer. Nothing here waits on the loop.
+class UserExport : public std::enable_shared_from_this<UserExport> {
+public:
+    UserExport(std::shared_ptr<DbClient> client,
+               std::weak_ptr<trantor::TcpConnection> connection,
+               bool jsonArray,
+               int lastId)
+        : _client(std::move(client)),
+          _connection(std::move(connection)),
+          _jsonArray(jsonArray),
+          _lastId(lastId) {}
+
+    // Called by drogon on the connection's loop once the headers are queued
+    void start(ResponseStreamPtr stream) {
+        _stream = std::move(stream);
+        _loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+        auto connection = _connection.lock();
+        _sentAtStart = connection ? connection->bytesSent() : 0;
+        fetch();
+    }
+
+private:
+    static constexpr double kExportFetchTimeoutSeconds = 10.0;
+    static constexpr double kExportDrainPollSeconds = 0.05;
+    static constexpr size_t kExportMaxUnsentBytes = 256 * 1024;
+
+    void fetch() {
+        auto self = shared_from_this();
+        uint64_t attempt = ++_attempt;
+        _fetching = true;
+        // A page that never comes must still end the body with an error, not a bare EOF
+        _loop->runAfter(kExportFetchTimeoutSeconds, [self, attempt]() {
+            if (self->_attempt == attempt && self->_fetching) {
+                self->fail("Export aborted: the database did not answer in time");
+            }
+        });
+        StatementRegistry::exec(
+            _client,
+            StatementRegistry::kListUsersAfter,
+            [self, attempt](const Result& r) {
+                self->_loop->queueInLoop([self, attempt, r]() { self->onPage(attempt, r); });
+            },
+            [self, attempt](const DrogonDbException& e) {
+                std::string message = "Export aborted: " + std::string(e.base().what());
+                self->_loop->queueInLoop([self, attempt, message]() {
+                    if (self->_attempt == attempt && self->_fetching) self->fail(message);
+                });
+            },
+            _lastId, kExportPageSize);
+    }
+
+    void onPage(uint64_t attempt, const Result& r) {
+        // A page that lost the race with its timeout is dropped
+        if (attempt != _attempt || !_fetching || !_stream) return;
+        _fetching = false;
+
+        std::string chunk;
+        for (const auto& row : r) {
+            User user(row["id"].as<int>(),
+                      row["username"].as<std::string>(),
+                      row["email"].as<std::string>());
+            if (_jsonArray) chunk += _rows == 0 ? "[" : ",";
+            writeJson(chunk, user);
+            if (!_jsonArray) chunk += "\n";
+            _lastId = user.getId();
+            ++_rows;
+        }
+
+        bool last = r.size() < static_cast<size_t>(kExportPageSize);
+        if (last && _jsonArray) chunk += _rows == 0 ? "[]" : "]";
+        if (!send(chunk)) return;
+        if (last) {
+            finish();
+        } else {
+            fetchWhenDrained();
+        }
+    }
+
+    // Query the next page once the client has read most of what is queued
+    void fetchWhenDrained() {
+        auto connection = _connection.lock();
+        if (!connection || !_stream) {
+            finish();
+            return;
+        }
+        size_t sent = connection->bytesSent() - _sentAtStart;
+        if (_queued <= sent + kExportMaxUnsentBytes) {
+            fetch();
+            return;
+        }
+        auto self = shared_from_this();
+        _loop->runAfter(kExportDrainPollSeconds, [self]() { self->fetchWhenDrained(); });
+    }
+
+    // Headers are already out; the error is the last element (json) or record (ndjson)
+    void fail(const std::string& message) {
+        if (!_stream) return;
+        _fetching = false;
+        Json::Value error;
+        error["error"] = message;
+        error["after_id"] = _lastId;
+        send(_jsonArray ? (_rows == 0 ? "[" : ",") + compactJson(error) + "]"
+                        : compactJson(error) + "\n");
+        finish();
+    }
+
+    bool send(const std::string& chunk) {
+        _queued += chunk.size();
+        if (_stream->send(chunk)) return true;
+        // Connection closed early
+        _stream.reset();
+        return false;
+    }
+
+    void finish() {
+        if (!_stream) return;
+        _stream->close();
+        _stream.reset();
+    }
+
+    std::shared_ptr<DbClient> _client;
+    std::weak_ptr<trantor::TcpConnection> _connection;
+    bool _jsonArray;
+
+    // Loop thread only
+    trantor::EventLoop* _loop = nullptr;
+    ResponseStreamPtr _stream;
+    size_t _sentAtStart = 0;        // Connection total before the body, headers aside
+    size_t _queued = 0;             // Body bytes handed to the stream
+    uint64_t _attempt = 0;          // Current page query, so a late answer is ignored
+    bool _fetching = false;
+    int _lastId;
+    size_t _rows = 0;
+};
+}
+
+void ApiController::getInfo(const HttpRequestPtr& req,
+                            std::function<void(const HttpResponsePtr&)>&& callback) {
+    // Same body for every client: built at most once per TTL, served from the response cache
+    ResponseCache::getInstance().serve(req, "/api/v1/info", {},
+        [](std::function<void(ResponseCache::Content)> done) {
+            Json::Value respJson;
+            respJson["service"] = "Drogon Web Server";
+            respJson["api_version"] = "v1";
+            respJson["database"] = DatabaseConfig::getInstance().getClient() ? "configured" : "not_configured";
+            done({k200OK, CT_APPLICATION_JSON, compactJson(respJson)});
+        },
+        std::move(callback));
+}
+
+void ApiController::listUsers(const HttpRequestPtr& req,
+                              std::function<void(const HttpResponsePtr&)>&& callback) {
+    auto client = DatabaseConfig::getInstance().getReadClient();
+    if (!client) {
+        callback(errorResponse(k503ServiceUnavailable, "Database not available"));
+        return;
+    }
+    
+    int lastId = 0;
+    const auto& cursor = req->getParameter("cursor");
+    if (!cursor.empty() && !decodeCursor(cursor, lastId)) {
+        callback(errorResponse(k400BadRequest, "Invalid cursor"));
+        return;
+    }
+    
+    // Full export, streamed as it is read
+    const auto& exportFormat = req->getParameter("export");
+    if (!exportFormat.empty()) {
+        if (exportFormat != "ndjson" && exportFormat != "json") {
+            callback(errorResponse(k400BadRequest, "export must be ndjson or json"));
+            return;
+        }
+        bool jsonArray = exportFormat == "json";
+        auto state = std::make_shared<UserExport>(client, req->getConnectionPtr(), jsonArray, lastId);
+        auto resp = HttpResponse::newAsyncStreamResponse(
+            [state](ResponseStreamPtr stream) { state->start(std::move(stream)); });
+        resp->setContentTypeString(jsonArray ? "application/json" : "application/x-ndjson");
+        callback(resp);
+        return;
+    }
+    
+    int limit = kDefaultPageSize;
+    const auto& limitParam = req->getParameter("limit");
+    if (!limitParam.empty()) {
+        try {
+            limit = std::clamp(std::stoi(limitParam), 1, kMaxPageSize);
+        } catch (const std::exception&) {
+            callback(errorResponse(k400BadRequest, "Invalid limit"));
+            return;
+        }
+    }
+    
+    // One extra row tells whether another page exists
+    StatementRegistry::exec(
+        client,
+        StatementRegistry::kListUsersAfter,
+        [callback, limit](const Result& r) {
+            Json::Value respJson;
+            respJson["users"] = Json::Value(Json::arrayValue);
+            size_t count = std::min(r.size(), static_cast<size_t>(limit));
+            int lastId = 0;
+            for (size_t i = 0; i < count; ++i) {
+                User user(r[i]["id"].as<int>(),
+                          r[i]["username"].as<std::string>(),
+                          r[i]["email"].as<std::string>());
+                respJson["users"].append(user.toJson());
+                lastId = user.getId();
+            }
+            respJson["next_cursor"] = r.size() > count ? Json::Value(encodeCursor(lastId)) : Json::Value();
+            callback(HttpResponse::newHttpJsonResponse(respJson));
+        },
+        [callback](const DrogonDbException& e) {
+            callback(errorResponse(k500InternalServerError, "Database error"));
+        },
+        lastId, limit + 1);
+}
+
+void ApiController::createUser(const HttpRequestPtr& req,
+                               std::function<void(const HttpResponsePtr&)>&& callback) {
+    const auto& contentType = req->getHeader("content-type");
+    UserImport::Format format;
+    if (hasPrefix(contentType, "application/x-ndjson") || hasPrefix(contentType, "application/jsonl")) {
+        format = UserImport::Format::kNdjson;
+    } else if (hasPrefix(contentType, "text/csv")) {
+        format = UserImport::Format::kCsv;
+    } else {
+        callback(errorResponse(k415UnsupportedMediaType,
+                               "Send application/x-ndjson or text/csv (header: username,email,password)"));
+        return;
+    }
+
+    std::string connInfo = DatabaseConfig::getInstance().getConnectionInfo();
+    if (connInfo.empty()) {
+        callback(errorResponse(k503ServiceUnavailable, "Database not available"));
+        return;
+    }
+
+    const auto& config = app().getCustomConfig()["user_import"];
+    unsigned maxConcurrent = config.get("max_concurrent", 2).asUInt();
+    if (runningImports.fetch_add(1) >= maxConcurrent) {
+        runningImports.fetch_sub(1);
+        auto resp = errorResponse(k503ServiceUnavailable, "Too many imports running, please retry");
+        resp->addHeader("Retry-After", "5");
+        callback(resp);
+        return;
+    }
+
+    // The request (and with it the body, which Drogon spools to a temp file when
+    // large) stays alive until the report is sent
+    auto* loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    auto options = UserImport::optionsFromConfig(config);
+    importLoop(maxConcurrent)->queueInLoop([req, callback = std::move(callback), loop, connInfo, format, options]() {
+        UserImport import(connInfo, format, options);
+        auto report = import.run(req->body());
+        runningImports.fetch_sub(1);
+
+        HttpStatusCode status = k200OK;
+        if (report.isMember("error")) {
+            status = import.connected() ? k400BadRequest : k503ServiceUnavailable;
+        }
+        loop->queueInLoop([callback, report, status]() {
+            auto resp = HttpResponse::newHttpJsonResponse(report);
+            resp->setStatusCode(status);
+            callback(resp);
+        });
+    });
+}
@@ -7,12 +7,19 @@ class ApiController : public HttpController<ApiController> {
 public:
     METHOD_LIST_BEGIN
         ADD_METHOD_TO(ApiController::getInfo, "/api/v1/info", Get);
-        ADD_METHOD_TO(ApiController::createUser, "/api/v1/users", Post);
+        ADD_METHOD_TO(ApiController::listUsers, "/api/v1/users", Get, "AuthFilter", "AdminFilter");
+        ADD_METHOD_TO(ApiController::createUser, "/api/v1/users", Post, "AuthFilter", "AdminFilter");
     METHOD_LIST_END
     
     void getInfo(const HttpRequestPtr& req,
                  std::function<void(const HttpResponsePtr&)>&& callback);
     
+    // Keyset-paginated listing (?limit=&cursor=), or ?export=ndjson|json to stream every
+    // user; admins only
+    void listUsers(const HttpRequestPtr& req,
+                   std::function<void(const HttpResponsePtr&)>&& callback);
+    
+    // Bulk import of an NDJSON or CSV body; admins only
     void createUser(const HttpRequestPtr& req,
                     std::function<void(const HttpResponsePtr&)>&& callback);
 };
\ No newline at end of file
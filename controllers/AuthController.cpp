@@ -1,128 +1,271 @@
 #include "AuthController.h"
+#include "AuthResponses.h"
 #include <drogon/orm/DbClient.h>
 #include <drogon/utils/Utilities.h>
 #include "DatabaseConfig.h"
+#include "HashExecutor.h"
+#include "JsonFieldExtractor.h"
+#include "RateLimitFilter.h"
+#include "RateLimiter.h"
+#include "RegisterBatcher.h"
+#include "SessionStore.h"
+#include "StatementRegistry.h"
+#include "TokenAuth.h"
+#include "UserCache.h"
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 using namespace drogon;
 using namespace drogon::orm;
 
+namespace {
+
+// Accounts created in the last few seconds. A replica may not have them yet, so a
+// replica miss for one of these (and only these) is worth asking the primary.
+class RecentSignups {
+public:
+    static constexpr std::chrono::seconds kWindow{5};
+
+    static RecentSignups& getInstance() {
+        static RecentSignups instance;
+        return instance;
+    }
+
+    void add(const std::string& username, const std::string& email, int id) {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> lock(_mutex);
+        expire(now);
+        for (auto key : {"login:" + username, "login:" + email, "id:" + std::to_string(id)}) {
+            _addedAt[key] = now;
+            _order.emplace_back(now, std::move(key));
+        }
+    }
+
+    bool hasLogin(const std::string& login) { return contains("login:" + login); }
+    bool hasId(int id) { return contains("id:" + std::to_string(id)); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool contains(const std::string& key) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        expire(Clock::now());
+        return _addedAt.count(key) > 0;
+    }
+
+    void expire(Clock::time_point now) {
+        while (!_order.empty() && now - _order.front().first >= kWindow) {
+            auto it = _addedAt.find(_order.front().second);
+            // A key added again later keeps its newer time
+            if (it != _addedAt.end() && it->second == _order.front().first) _addedAt.erase(it);
+            _order.pop_front();
+        }
+    }
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Clock::time_point> _addedAt;
+    std::deque<std::pair<Clock::time_point, std::string>> _order;
+};
+
+// Hash pool is saturated: shed the request instead of queueing it on the IO loop
+HttpResponsePtr busyResponse() {
+    auto resp = newJsonResponse(ErrorBody{"Server busy, please retry"}, k503ServiceUnavailable);
+    resp->addHeader("Retry-After", "1");
+    return resp;
+}
+
+const JsonFieldExtractor::Limits& bodyLimits() {
+    static const auto limits = JsonFieldExtractor::limitsFromConfig(app().getCustomConfig()["auth_body"]);
+    return limits;
+}
+
+// Extract the string fields of a JSON body without building a DOM. When the body
+// is unusable the request is answered here (413, or 400 with missingMessage).
+bool extractFields(const HttpRequestPtr& req,
+                   JsonFieldExtractor& fields,
+                   std::string_view missingMessage,
+                   const std::function<void(const HttpResponsePtr&)>& callback) {
+    auto status = fields.parse(req->body());
+    if (status == JsonFieldExtractor::Status::kTooLarge) {
+        callback(newJsonResponse(ErrorBody{"Request body too large"}, k413RequestEntityTooLarge));
+        return false;
+    }
+    // Same acceptance as getJsonObject(): JSON content type and every field present
+    if (req->contentType() != CT_APPLICATION_JSON ||
+        status != JsonFieldExtractor::Status::kOk || !fields.hasAll()) {
+        callback(newJsonResponse(ErrorBody{missingMessage}, k400BadRequest));
+        return false;
+    }
+    return true;
+}
+
+// Run a read-only query on a replica. An error is retried on the primary. An empty
+// result is retried only when mayLag says the row was written moments ago (see
+// RecentSignups), so unknown-user traffic never reaches the primary.
+template <typename... Arguments>
+void execRead(StatementRegistry::Id statement,
+              bool mayLag,
+              std::function<void(const Result&)> onResult,
+              std::function<void(const DrogonDbException&)> onError,
+              Arguments... args) {
+    auto& config = DatabaseConfig::getInstance();
+    auto primary = config.getClient();
+    auto readClient = config.getReadClient();
+    if (!readClient || readClient == primary) {
+        StatementRegistry::exec(primary, statement, std::move(onResult), std::move(onError), args...);
+        return;
+    }
+    
+    auto retryOnPrimary = [primary, statement, onResult, onError, args...]() {
+        StatementRegistry::exec(primary, statement, onResult, onError, args...);
+    };
+    StatementRegistry::exec(
+        readClient,
+        statement,
+        [onResult, retryOnPrimary, mayLag](const Result& r) {
+            if (r.empty() && mayLag) {
+                retryOnPrimary();
+                return;
+            }
+            onResult(r);
+        },
+        [retryOnPrimary](const DrogonDbException&) { retryOnPrimary(); },
+        args...);
+}
+
+}
+
 void AuthController::asyncHandleHttpRequest(
     const HttpRequestPtr& req,
     std::function<void(const HttpResponsePtr&)>&& callback) {
     
-    auto json = req->getJsonObject();
     auto dbClient = DatabaseConfig::getInstance().getClient();
     
+    // Hash jobs run on HashExecutor workers and resume on this IO loop
+    auto* loop = trantor::EventLoop::getEventLoopOfCurrentThread();
+    
     if (!dbClient) {
-        Json::Value respJson;
-        respJson["error"] = "Database not available";
-        auto resp = HttpResponse::newHttpJsonResponse(respJson);
-        resp->setStatusCode(k503ServiceUnavailable);
-        callback(resp);
+        callback(newJsonResponse(ErrorBody{"Database not available"}, k503ServiceUnavailable));
         return;
     }
     
     // REGISTER
     if (req->getPath() == "/api/register") {
-        if (!json || !json->isMember("username") || 
-            !json->isMember("email") || !json->isMember("password")) {
-            Json::Value respJson;
-            respJson["error"] = "Missing fields";
-            auto resp = HttpResponse::newHttpJsonResponse(respJson);
-            resp->setStatusCode(k400BadRequest);
-            callback(resp);
+        enum { kUsername, kEmail, kPassword };
+        JsonFieldExtractor fields({"username", "email", "password"}, bodyLimits());
+        if (!extractFields(req, fields, "Missing fields", callback)) {
             return;
         }
         
-        std::string username = (*json)["username"].asString();
-        std::string email = (*json)["email"].asString();
-        std::string password = (*json)["password"].asString();
-        
-        // SIMPLIFY: Use SHA256 for now
-        std::string passwordHash = drogon::utils::getSha256(password);
-        
-        dbClient->execSqlAsync(
-            "INSERT INTO users (username, email, password_hash) VALUES ($1, $2, $3) RETURNING id",
-            [callback](const Result& r) {
-                if (!r.empty()) {
-                    Json::Value respJson;
-                    respJson["success"] = true;
-                    respJson["message"] = "User created successfully";
-                    auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                    callback(resp);
+        // Copied once, straight from the body, into what the async steps own
+        bool queued = HashExecutor::getInstance().hashPassword(loop, std::string(fields.get(kPassword)),
+            [callback, loop, username = std::string(fields.get(kUsername)),
+             email = std::string(fields.get(kEmail))](std::optional<std::string> passwordHash) {
+                if (!passwordHash) {
+                    callback(newJsonResponse(ErrorBody{"Internal error"}, k500InternalServerError));
+                    return;
                 }
-            },
-            [callback](const DrogonDbException& e) {
-                Json::Value respJson;
-                respJson["error"] = "Username or email already exists";
-                auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                resp->setStatusCode(k400BadRequest);
-                callback(resp);
-            },
-            username, email, passwordHash
-        );
+                
+                // Concurrent signups share one multi-row INSERT
+                RegisterBatcher::getInstance().submit(
+                    loop,
+                    {username, email, std::move(*passwordHash)},
+                    [callback, username, email](RegisterBatcher::Outcome outcome) {
+                        if (outcome.status == RegisterBatcher::Status::kCreated) {
+                            RecentSignups::getInstance().add(username, email, outcome.id);
+                            
+                            // Never serve a stale profile for this id
+                            UserCache::getInstance().invalidate(outcome.id);
+                            
+                            callback(newJsonResponse(MessageBody{true, "User created successfully"}));
+                            return;
+                        }
+                        
+                        bool conflict = outcome.status == RegisterBatcher::Status::kConflict;
+                        callback(newJsonResponse(
+                            ErrorBody{conflict ? "Username or email already exists" : "Database error"},
+                            conflict ? k400BadRequest : k500InternalServerError));
+                    });
+            });
+        
+        if (!queued) {
+            callback(busyResponse());
+        }
     }
     
     // LOGIN
     else if (req->getPath() == "/api/login") {
-        if (!json || !json->isMember("username") || !json->isMember("password")) {
-            Json::Value respJson;
-            respJson["error"] = "Missing username or password";
-            auto resp = HttpResponse::newHttpJsonResponse(respJson);
-            resp->setStatusCode(k400BadRequest);
-            callback(resp);
+        enum { kUsername, kPassword };
+        JsonFieldExtractor fields({"username", "password"}, bodyLimits());
+        if (!extractFields(req, fields, "Missing username or password", callback)) {
             return;
         }
         
-        std::string username = (*json)["username"].asString();
-        std::string password = (*json)["password"].asString();
+        std::string username(fields.get(kUsername));
+        std::string password(fields.get(kPassword));
         
-        dbClient->execSqlAsync(
-            "SELECT id, username, email, password_hash FROM users WHERE username = $1 OR email = $1",
-            [password, callback, req](const Result& r) {
+        bool mayLag = RecentSignups::getInstance().hasLogin(username);
+        execRead(
+            StatementRegistry::kFindUserByLogin,
+            mayLag,
+            [password, callback, req, loop](const Result& r) {
                 if (r.empty()) {
-                    Json::Value respJson;
-                    respJson["error"] = "Invalid credentials";
-                    auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                    resp->setStatusCode(k401Unauthorized);
-                    callback(resp);
+                    callback(newJsonResponse(ErrorBody{"Invalid credentials"}, k401Unauthorized));
                     return;
                 }
                 
+                // One bucket per account, whichever of its names was sent
+                auto& limiter = RateLimiter::getInstance();
+                if (limiter.enabled()) {
+                    auto decision = limiter.checkUserId(r[0]["id"].as<int>());
+                    if (!decision.allowed) {
+                        callback(RateLimitFilter::tooManyRequests(decision.retryAfterSeconds));
+                        return;
+                    }
+                }
+                
                 std::string storedHash = r[0]["password_hash"].as<std::string>();
+                User user(r[0]["id"].as<int>(),
+                          r[0]["username"].as<std::string>(),
+                          r[0]["email"].as<std::string>());
                 
-                // SIMPLIFY: Use SHA256 for now
-                bool isValid = (drogon::utils::getSha256(password) == storedHash);
+                bool queued = HashExecutor::getInstance().verifyPassword(loop, password, storedHash,
+                    [callback, req, user](std::optional<bool> isValid) {
+                        if (!isValid) {
+                            callback(newJsonResponse(ErrorBody{"Internal error"}, k500InternalServerError));
+                            return;
+                        }
+                        if (!*isValid) {
+                            callback(newJsonResponse(ErrorBody{"Invalid credentials"}, k401Unauthorized));
+                            return;
+                        }
+                        
+                        // Warm the profile cache so /api/me skips the DB
+                        UserCache::getInstance().put(user);
+                        
+                        SessionData session;
+                        session.userId = user.getId();
+                        session.setUsername(user.getUsername());
+                        
+                        auto resp = newJsonResponse(LoginBody{true, &user});
+                        auto& tokens = TokenAuth::getInstance();
+                        if (tokens.enabled()) {
+                            tokens.start(resp, session);
+                        } else {
+                            SessionStore::getInstance().start(req, resp, session);
+                        }
+                        callback(resp);
+                    });
                 
-                if (isValid) {
-                    auto session = req->session();
-                    session->insert("user_id", r[0]["id"].as<int>());
-                    session->insert("username", r[0]["username"].as<std::string>());
-                    
-                    Json::Value respJson;
-                    respJson["success"] = true;
-                    Json::Value userJson;
-                    userJson["id"] = r[0]["id"].as<int>();
-                    userJson["username"] = r[0]["username"].as<std::string>();
-                    userJson["email"] = r[0]["email"].as<std::string>();
-                    respJson["user"] = userJson;
-                    
-                    auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                    callback(resp);
-                } else {
-                    Json::Value respJson;
-                    respJson["error"] = "Invalid credentials";
-                    auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                    resp->setStatusCode(k401Unauthorized);
-                    callback(resp);
+                if (!queued) {
+                    callback(busyResponse());
                 }
             },
             [callback](const DrogonDbException& e) {
-                Json::Value respJson;
-                respJson["error"] = "Database error: " + std::string(e.base().what());
-                auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
+                std::string error = "Database error: " + std::string(e.base().what());
+                callback(newJsonResponse(ErrorBody{error}, k500InternalServerError));
             },
             username
         );
@@ -130,58 +273,50 @@ void AuthController::asyncHandleHttpRequest(
     
     // LOGOUT
     else if (req->getPath() == "/api/logout") {
-        req->session()->erase("user_id");
-        req->session()->erase("username");
-        
-        Json::Value respJson;
-        respJson["success"] = true;
-        respJson["message"] = "Logged out";
-        auto resp = HttpResponse::newHttpJsonResponse(respJson);
+        auto resp = newJsonResponse(MessageBody{true, "Logged out"});
+        auto& tokens = TokenAuth::getInstance();
+        if (tokens.enabled()) {
+            tokens.end(resp);
+        } else {
+            SessionStore::getInstance().end(req, resp);
+        }
         callback(resp);
     }
     
     // GET CURRENT USER
     else if (req->getPath() == "/api/me") {
-        auto session = req->session();
-        if (!session || !session->find("user_id")) {
-            Json::Value respJson;
-            respJson["error"] = "Not authenticated";
-            auto resp = HttpResponse::newHttpJsonResponse(respJson);
-            resp->setStatusCode(k401Unauthorized);
-            callback(resp);
+        auto& tokens = TokenAuth::getInstance();
+        auto session = tokens.enabled() ? tokens.find(req) : SessionStore::getInstance().find(req);
+        if (!session) {
+            callback(newJsonResponse(ErrorBody{"Not authenticated"}, k401Unauthorized));
             return;
         }
         
-        int userId = session->get<int>("user_id");
+        int userId = session->userId;
+        
+        if (auto cached = UserCache::getInstance().get(userId)) {
+            callback(newJsonResponse(UserBody{cached.get()}));
+            return;
+        }
         
-        dbClient->execSqlAsync(
-            "SELECT id, username, email FROM users WHERE id = $1",
+        execRead(
+            StatementRegistry::kFindUserById,
+            RecentSignups::getInstance().hasId(userId),
             [callback](const Result& r) {
                 if (r.empty()) {
-                    Json::Value respJson;
-                    respJson["error"] = "User not found";
-                    auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                    resp->setStatusCode(k404NotFound);
-                    callback(resp);
+                    callback(newJsonResponse(ErrorBody{"User not found"}, k404NotFound));
                     return;
                 }
                 
-                Json::Value respJson;
-                Json::Value userJson;
-                userJson["id"] = r[0]["id"].as<int>();
-                userJson["username"] = r[0]["username"].as<std::string>();
-                userJson["email"] = r[0]["email"].as<std::string>();
-                respJson["user"] = userJson;
+                User user(r[0]["id"].as<int>(),
+                          r[0]["username"].as<std::string>(),
+                          r[0]["email"].as<std::string>());
+                UserCache::getInstance().put(user);
                 
-                auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                callback(resp);
+                callback(newJsonResponse(UserBody{&user}));
             },
             [callback](const DrogonDbException& e) {
-                Json::Value respJson;
-                respJson["error"] = "Database error";
-                auto resp = HttpResponse::newHttpJsonResponse(respJson);
-                resp->setStatusCode(k500InternalServerError);
-                callback(resp);
+                callback(newJsonResponse(ErrorBody{"Database error"}, k500InternalServerError));
             },
             userId
         );
@@ -189,11 +324,7 @@ void AuthController::asyncHandleHttpRequest(
     
     // Unknown endpoint
     else {
-        Json::Value respJson;
-        respJson["error"] = "Not found";
-        auto resp = HttpResponse::newHttpJsonResponse(respJson);
-        resp->setStatusCode(k404NotFound);
-        callback(resp);
+        callback(newJsonResponse(ErrorBody{"Not found"}, k404NotFound));
     }
 }
 // END OF FILE - NO EXTRA TEXT HERE
\ No newline at end of file
@@ -9,8 +9,8 @@ public:
         std::function<void(const drogon::HttpResponsePtr&)>&& callback) override;
     
     PATH_LIST_BEGIN
-    PATH_ADD("/api/register", drogon::Post);
-    PATH_ADD("/api/login", drogon::Post);
+    PATH_ADD("/api/register", drogon::Post, "RateLimitFilter");
+    PATH_ADD("/api/login", drogon::Post, "RateLimitFilter");
     PATH_ADD("/api/logout", drogon::Post);
     PATH_ADD("/api/me", drogon::Get);
     PATH_LIST_END
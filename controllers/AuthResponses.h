@@ -0,0 +1,53 @@
+// AuthResponses.h
+#pragma once
+#include <string_view>
+#include "JsonWriter.h"
+#include "User.h"
+
+// Fixed JSON bodies of the auth endpoints, serialized through JsonWriter
+
+// { "error": "..." }
+struct ErrorBody {
+    std::string_view error;
+};
+
+// { "success": true, "message": "..." }
+struct MessageBody {
+    bool success = true;
+    std::string_view message;
+};
+
+// { "success": true, "user": {...} }
+struct LoginBody {
+    bool success = true;
+    const User* user = nullptr;
+};
+
+// { "user": {...} }
+struct UserBody {
+    const User* user = nullptr;
+};
+
+template <>
+struct JsonSchema<ErrorBody> {
+    static constexpr auto fields = std::make_tuple(jsonField("error", &ErrorBody::error));
+};
+
+template <>
+struct JsonSchema<MessageBody> {
+    static constexpr auto fields = std::make_tuple(
+        jsonField("success", &MessageBody::success),
+        jsonField("message", &MessageBody::message));
+};
+
+template <>
+struct JsonSchema<LoginBody> {
+    static constexpr auto fields = std::make_tuple(
+        jsonField("success", &LoginBody::success),
+        jsonField("user", &LoginBody::user));
+};
+
+template <>
+struct JsonSchema<UserBody> {
+    static constexpr auto fields = std::make_tuple(jsonField("user", &UserBody::user));
+};
@@ -0,0 +1,34 @@
+#include "AdminFilter.h"
+#include "AsyncLog.h"
+#include "AuthFilter.h"
+
+void AdminFilter::configure(const Json::Value& config) {
+    auto& ids = adminIds();
+    ids.clear();
+    for (const auto& id : config["user_ids"]) {
+        if (id.isInt() && id.asInt() > 0) ids.insert(id.asInt());
+    }
+    AsyncLog::info() << "Admin routes: " << ids.size() << " admin user(s)";
+}
+
+void AdminFilter::doFilter(const drogon::HttpRequestPtr& req,
+                           drogon::FilterCallback&& fcb,
+                           drogon::FilterChainCallback&& fccb) {
+    int userId = AuthFilter::userIdOf(req);
+    if (userId > 0 && adminIds().count(userId)) {
+        fccb();
+        return;
+    }
+
+    Json::Value json;
+    json["error"] = "Admin access required";
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(json);
+    resp->setStatusCode(drogon::k403Forbidden);
+    fcb(resp);
+}
+
+std::unordered_set<int>& AdminFilter::adminIds() {
+    // Filled once at startup, read-only while serving
+    static std::unordered_set<int> ids;
+    return ids;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <drogon/HttpFilter.h>
+#include <unordered_set>
+
+// Admin-only routes (user listing, export and bulk import). Runs after AuthFilter
+// and lets through only the user ids listed in custom_config.admin.user_ids.
+class AdminFilter : public drogon::HttpFilter<AdminFilter> {
+public:
+    // Load the admin list from a config section: { "user_ids": [1] }.
+    // Call before the server starts; an empty list closes the admin routes.
+    static void configure(const Json::Value& config);
+
+    void doFilter(const drogon::HttpRequestPtr& req,
+                  drogon::FilterCallback&& fcb,
+                  drogon::FilterChainCallback&& fccb) override;
+
+private:
+    static std::unordered_set<int>& adminIds();
+};
@@ -1,45 +1,36 @@
 #include "AuthFilter.h"
+#include "AsyncLog.h"
+#include "RoutePolicy.h"
+#include "SessionStore.h"
+#include "TokenAuth.h"
+
+namespace {
+
+const std::string kUserIdAttribute = "auth_user_id";
+
+}
 
 void AuthFilter::doFilter(const drogon::HttpRequestPtr& req,
                           drogon::FilterCallback&& fcb,
                           drogon::FilterChainCallback&& fccb) {
     
-    auto session = req->session();
-    
-    // Public routes (no auth required)
-    std::vector<std::string> publicRoutes = {
-        "/api/login",
-        "/api/register",
-        "/",
-        "/login.html",
-        "/register.html",
-        "/css/",
-        "/js/",
-        "/fonts/"
-    };
-    
-    std::string path = req->getPath();
+    const std::string& path = req->path();
     
-    // Check if route is public
-    bool isPublic = false;
-    for (const auto& route : publicRoutes) {
-        if (path.find(route) == 0) {
-            isPublic = true;
-            break;
-        }
-    }
-    
-    if (isPublic) {
+    // Public routes (no auth required), decided by the startup-compiled policy
+    if (RoutePolicy::getInstance().decide(path) == RoutePolicy::Decision::Public) {
         fccb(); // Continue to next filter/controller
         return;
     }
     
-    // Check if user is authenticated
-    if (!session || !session->find("user_id")) {
+    // Check if user is authenticated: a signature check in token mode, otherwise one
+    // shard lookup (which also extends the session)
+    auto& tokens = TokenAuth::getInstance();
+    auto session = tokens.enabled() ? tokens.find(req) : SessionStore::getInstance().find(req);
+    if (!session) {
         auto resp = drogon::HttpResponse::newHttpResponse();
         
         // For API requests, return JSON
-        if (path.find("/api/") == 0) {
+        if (path.compare(0, 5, "/api/") == 0) {
             Json::Value json;
             json["error"] = "Not authenticated";
             resp = drogon::HttpResponse::newHttpJsonResponse(json);
@@ -55,5 +46,12 @@ void AuthFilter::doFilter(const drogon::HttpRequestPtr& req,
         return;
     }
     
+    AsyncLog::tagUser(req, session->userId);
+    req->attributes()->insert(kUserIdAttribute, session->userId);
     fccb(); // User is authenticated, continue
+}
+
+int AuthFilter::userIdOf(const drogon::HttpRequestPtr& req) {
+    const auto& attributes = req->attributes();
+    return attributes->find(kUserIdAttribute) ? attributes->get<int>(kUserIdAttribute) : 0;
 }
\ No newline at end of file
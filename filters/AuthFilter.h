@@ -6,4 +6,7 @@ public:
     void doFilter(const drogon::HttpRequestPtr& req,
                   drogon::FilterCallback&& fcb,
                   drogon::FilterChainCallback&& fccb) override;
+
+    // Id of the user this filter authenticated for req; 0 on public routes
+    static int userIdOf(const drogon::HttpRequestPtr& req);
 };
\ No newline at end of file
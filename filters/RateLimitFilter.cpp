@@ -0,0 +1,62 @@
+#include "RateLimitFilter.h"
+#include "RateLimiter.h"
+#include "JsonFieldExtractor.h"
+
+void RateLimitFilter::doFilter(const drogon::HttpRequestPtr& req,
+                               drogon::FilterCallback&& fcb,
+                               drogon::FilterChainCallback&& fccb) {
+    
+    auto& limiter = RateLimiter::getInstance();
+    if (!limiter.enabled()) {
+        fccb();
+        return;
+    }
+    
+    // Per client IP first: cheapest key, stops credential-stuffing sources. Behind a
+    // configured proxy the client comes from X-Forwarded-For, not the proxy's address.
+    auto decision = limiter.checkIp(limiter.clientIp(req->peerAddr().toIp(), req->getHeader("x-forwarded-for")));
+    if (!decision.allowed) {
+        fcb(tooManyRequests(decision.retryAfterSeconds));
+        return;
+    }
+    
+    // Then per account, so one target cannot be hammered from many IPs. The login
+    // name and, on register, the email are read straight from the body; oversized
+    // bodies stop here. Login also accepts the email as the name, so the handler
+    // charges the resolved user's bucket too (RateLimiter::checkUserId).
+    static const auto limits = JsonFieldExtractor::limitsFromConfig(
+        drogon::app().getCustomConfig()["auth_body"]);
+    JsonFieldExtractor fields({"username", "email"}, limits);
+    auto status = fields.parse(req->body());
+    if (status == JsonFieldExtractor::Status::kTooLarge) {
+        Json::Value json;
+        json["error"] = "Request body too large";
+        auto resp = drogon::HttpResponse::newHttpJsonResponse(json);
+        resp->setStatusCode(drogon::k413RequestEntityTooLarge);
+        fcb(resp);
+        return;
+    }
+    if (status == JsonFieldExtractor::Status::kOk) {
+        for (size_t field = 0; field < 2; ++field) {
+            if (!fields.has(field)) continue;
+            decision = limiter.checkAccount(fields.get(field));
+            if (!decision.allowed) {
+                fcb(tooManyRequests(decision.retryAfterSeconds));
+                return;
+            }
+        }
+    }
+    
+    limiter.recordAllowed();
+    fccb();
+}
+
+drogon::HttpResponsePtr RateLimitFilter::tooManyRequests(int retryAfterSeconds) {
+    Json::Value json;
+    json["error"] = "Too many requests";
+    json["retry_after"] = retryAfterSeconds;
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(json);
+    resp->setStatusCode(drogon::k429TooManyRequests);
+    resp->addHeader("Retry-After", std::to_string(retryAfterSeconds));
+    return resp;
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <drogon/HttpFilter.h>
+
+// Sheds login/register bursts per client IP and per account before any DB work
+class RateLimitFilter : public drogon::HttpFilter<RateLimitFilter> {
+public:
+    void doFilter(const drogon::HttpRequestPtr& req,
+                  drogon::FilterCallback&& fcb,
+                  drogon::FilterChainCallback&& fccb) override;
+
+    // 429 with Retry-After, also used by handlers that limit after a lookup
+    static drogon::HttpResponsePtr tooManyRequests(int retryAfterSeconds);
+};
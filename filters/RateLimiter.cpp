@@ -0,0 +1,167 @@
+// RateLimiter.cpp
+#include "RateLimiter.h"
+#include "AsyncLog.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+int64_t nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+RateLimiter::Limit parseLimit(const Json::Value& config, RateLimiter::Limit fallback) {
+    if (!config.isObject()) return fallback;
+    RateLimiter::Limit limit = fallback;
+    if (config["burst"].isNumeric()) limit.burst = std::max(1.0, config["burst"].asDouble());
+    if (config["per_second"].isNumeric()) limit.perSecond = std::max(0.001, config["per_second"].asDouble());
+    return limit;
+}
+
+}
+
+RateLimiter& RateLimiter::getInstance() {
+    static RateLimiter instance;
+    return instance;
+}
+
+void RateLimiter::configure(const Json::Value& config) {
+    if (config.isObject()) {
+        _enabled = config.get("enabled", true).asBool();
+        _perIp = parseLimit(config["per_ip"], _perIp);
+        _perAccount = parseLimit(config["per_account"], _perAccount);
+        if (config["idle_seconds"].isInt64()) {
+            _idleSeconds = std::max<int64_t>(1, config["idle_seconds"].asInt64());
+        }
+        _trustedProxies.clear();
+        for (const auto& proxy : config["trusted_proxies"]) {
+            if (proxy.isString()) _trustedProxies.insert(proxy.asString());
+        }
+    }
+
+    AsyncLog::info() << "Rate limiter: " << (_enabled ? "enabled" : "disabled")
+                     << " (per IP " << _perIp.burst << " burst, " << _perIp.perSecond << "/s;"
+                     << " per account " << _perAccount.burst << " burst, " << _perAccount.perSecond << "/s)"
+                     << ", " << _trustedProxies.size() << " trusted proxy address(es)";
+}
+
+std::string RateLimiter::clientIp(const std::string& peer, std::string_view forwardedFor) const {
+    if (forwardedFor.empty() || !_trustedProxies.count(peer)) return peer;
+
+    // Each proxy appends the address it got the request from; walk back from the
+    // nearest hop and stop at the first one a trusted proxy did not vouch for
+    std::string_view client;
+    while (!forwardedFor.empty()) {
+        size_t comma = forwardedFor.rfind(',');
+        auto hop = trim(comma == std::string_view::npos ? forwardedFor : forwardedFor.substr(comma + 1));
+        forwardedFor = comma == std::string_view::npos ? std::string_view() : forwardedFor.substr(0, comma);
+        if (hop.empty()) continue;
+        client = hop;
+        if (!_trustedProxies.count(std::string(hop))) break;
+    }
+    return client.empty() ? peer : std::string(client);
+}
+
+RateLimiter::Decision RateLimiter::checkIp(std::string_view ip) {
+    std::string key;
+    key.reserve(3 + ip.size());
+    key.append("ip:").append(ip);
+
+    auto decision = take(std::move(key), _perIp);
+    if (!decision.allowed) _limitedIp.fetch_add(1, std::memory_order_relaxed);
+    return decision;
+}
+
+RateLimiter::Decision RateLimiter::checkAccount(std::string_view account) {
+    std::string key;
+    key.reserve(5 + account.size());
+    key.append("user:");
+    for (char c : account) {
+        key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+
+    auto decision = take(std::move(key), _perAccount);
+    if (!decision.allowed) _limitedAccount.fetch_add(1, std::memory_order_relaxed);
+    return decision;
+}
+
+RateLimiter::Decision RateLimiter::checkUserId(int userId) {
+    auto decision = take("uid:" + std::to_string(userId), _perAccount);
+    if (!decision.allowed) _limitedAccount.fetch_add(1, std::memory_order_relaxed);
+    return decision;
+}
+
+RateLimiter::Decision RateLimiter::take(std::string key, const Limit& limit) {
+    auto now = nowMicros();
+    auto& shard = _shards[std::hash<std::string>{}(key) % kShardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        it = shard.buckets.emplace(key, Bucket{limit.burst, now}).first;
+        schedule(shard, std::move(key), _idleSeconds);
+    }
+
+    auto& bucket = it->second;
+    double elapsed = static_cast<double>(now - bucket.lastRefillUs) / 1e6;
+    bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.perSecond);
+    bucket.lastRefillUs = now;
+
+    Decision decision;
+    if (bucket.tokens >= 1.0) {
+        bucket.tokens -= 1.0;
+    } else {
+        decision.allowed = false;
+        decision.retryAfterSeconds =
+            std::max(1, static_cast<int>(std::ceil((1.0 - bucket.tokens) / limit.perSecond)));
+    }
+    return decision;
+}
+
+void RateLimiter::schedule(Shard& shard, std::string key, int64_t ticksFromNow) {
+    // Longer delays land on the farthest slot and get rescheduled when it comes round
+    auto ticks = static_cast<size_t>(std::clamp<int64_t>(ticksFromNow, 1, kWheelSlots - 1));
+    shard.wheel[(shard.cursor + ticks) % kWheelSlots].push_back(std::move(key));
+}
+
+void RateLimiter::tick() {
+    auto now = nowMicros();
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.cursor = (shard.cursor + 1) % kWheelSlots;
+
+        std::vector<std::string> due;
+        due.swap(shard.wheel[shard.cursor]);
+        for (auto& key : due) {
+            auto it = shard.buckets.find(key);
+            if (it == shard.buckets.end()) continue;
+
+            int64_t idleSeconds = (now - it->second.lastRefillUs) / 1000000;
+            if (idleSeconds >= _idleSeconds) {
+                shard.buckets.erase(it);
+                _evicted.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                schedule(shard, std::move(key), _idleSeconds - idleSeconds);
+            }
+        }
+    }
+}
+
+size_t RateLimiter::bucketCount() const {
+    size_t total = 0;
+    for (const auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.buckets.size();
+    }
+    return total;
+}
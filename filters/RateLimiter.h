@@ -0,0 +1,99 @@
+// RateLimiter.h
+#pragma once
+#include <json/json.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Sharded token buckets keyed by client IP and by account name.
+// Idle buckets are dropped by a timing wheel advanced once per second.
+class RateLimiter {
+public:
+    struct Limit {
+        double burst = 10;       // Bucket capacity
+        double perSecond = 1;    // Refill rate
+    };
+
+    struct Decision {
+        bool allowed = true;
+        int retryAfterSeconds = 0;
+    };
+
+    // Singleton instance
+    static RateLimiter& getInstance();
+
+    // Load limits from a config section:
+    //   { "enabled": true, "idle_seconds": 120, "trusted_proxies": ["127.0.0.1"],
+    //     "per_ip": { "burst": 20, "per_second": 2 },
+    //     "per_account": { "burst": 5, "per_second": 0.2 } }
+    void configure(const Json::Value& config);
+
+    bool enabled() const { return _enabled; }
+
+    // Address to rate limit: the peer, unless the peer is a trusted proxy, in which
+    // case the nearest X-Forwarded-For hop that is not a trusted proxy
+    std::string clientIp(const std::string& peer, std::string_view forwardedFor) const;
+
+    // Take one token from the client IP's bucket
+    Decision checkIp(std::string_view ip);
+
+    // Take one token from the account's bucket (case-insensitive)
+    Decision checkAccount(std::string_view account);
+
+    // Take one token from the bucket of a resolved user, shared by every login name
+    // (username or email) that leads to it; same limit as checkAccount
+    Decision checkUserId(int userId);
+
+    // Count a request that passed every check; a denial is counted by the check itself
+    void recordAllowed() { _allowed.fetch_add(1, std::memory_order_relaxed); }
+
+    // Advance the eviction wheel by one tick; called every second
+    void tick();
+
+    uint64_t allowedCount() const { return _allowed.load(std::memory_order_relaxed); }
+    uint64_t limitedIpCount() const { return _limitedIp.load(std::memory_order_relaxed); }
+    uint64_t limitedAccountCount() const { return _limitedAccount.load(std::memory_order_relaxed); }
+    uint64_t evictedCount() const { return _evicted.load(std::memory_order_relaxed); }
+    size_t bucketCount() const;
+
+private:
+    RateLimiter() = default;
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    static constexpr size_t kShardCount = 32;
+    static constexpr size_t kWheelSlots = 64;
+
+    struct Bucket {
+        double tokens = 0;
+        int64_t lastRefillUs = 0;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Bucket> buckets;
+        std::array<std::vector<std::string>, kWheelSlots> wheel;
+        size_t cursor = 0;
+    };
+
+    Decision take(std::string key, const Limit& limit);
+    void schedule(Shard& shard, std::string key, int64_t ticksFromNow);
+
+    std::array<Shard, kShardCount> _shards;
+    Limit _perIp{20, 2};
+    Limit _perAccount{5, 0.2};
+    int64_t _idleSeconds = 120;
+    bool _enabled = true;
+    std::unordered_set<std::string> _trustedProxies;    // Fixed after configure()
+
+    std::atomic<uint64_t> _allowed{0};
+    std::atomic<uint64_t> _limitedIp{0};
+    std::atomic<uint64_t> _limitedAccount{0};
+    std::atomic<uint64_t> _evicted{0};
+};
@@ -0,0 +1,145 @@
+// RoutePolicy.cpp
+#include "RoutePolicy.h"
+#include "AsyncLog.h"
+#include <algorithm>
+
+RoutePolicy& RoutePolicy::getInstance() {
+    static RoutePolicy instance;
+    return instance;
+}
+
+RoutePolicy::RoutePolicy() {
+    load(defaultRules(), Decision::Authenticated);
+}
+
+std::vector<RoutePolicy::Rule> RoutePolicy::defaultRules() {
+    return {
+        {"/", Match::Exact, Decision::Public},
+        {"/login", Match::Exact, Decision::Public},
+        {"/login.html", Match::Exact, Decision::Public},
+        {"/register.html", Match::Exact, Decision::Public},
+        {"/health", Match::Exact, Decision::Public},
+        {"/metrics", Match::Exact, Decision::Public},
+        {"/api/login", Match::Exact, Decision::Public},
+        {"/api/register", Match::Exact, Decision::Public},
+        {"/css/", Match::Prefix, Decision::Public},
+        {"/js/", Match::Prefix, Decision::Public},
+        {"/fonts/", Match::Prefix, Decision::Public},
+    };
+}
+
+void RoutePolicy::load(const std::vector<Rule>& rules, Decision defaultDecision) {
+    _exact.clear();
+    _prefix.clear();
+    _glob.clear();
+    _default = defaultDecision;
+
+    for (const auto& rule : rules) {
+        switch (rule.match) {
+            case Match::Exact: _exact.push_back(rule); break;
+            case Match::Prefix: _prefix.push_back(rule); break;
+            case Match::Glob: _glob.push_back(rule); break;
+        }
+    }
+
+    std::sort(_exact.begin(), _exact.end(),
+              [](const Rule& a, const Rule& b) { return a.pattern < b.pattern; });
+    std::stable_sort(_prefix.begin(), _prefix.end(),
+                     [](const Rule& a, const Rule& b) { return a.pattern.size() > b.pattern.size(); });
+}
+
+void RoutePolicy::load(const Json::Value& config) {
+    if (!config.isObject() || !config.isMember("rules") || !config["rules"].isArray() ||
+        config["rules"].empty()) {
+        AsyncLog::info() << "Route policy: using built-in rules";
+        return;
+    }
+
+    auto parseDecision = [](const std::string& value, Decision fallback) {
+        if (value == "public") return Decision::Public;
+        if (value == "authenticated") return Decision::Authenticated;
+        return fallback;
+    };
+
+    Decision defaultDecision = parseDecision(config.get("default", "authenticated").asString(),
+                                             Decision::Authenticated);
+
+    std::vector<Rule> rules;
+    for (const auto& item : config["rules"]) {
+        if (!item.isObject() || !item["path"].isString()) {
+            AsyncLog::error() << "Route policy: skipping rule without 'path'";
+            continue;
+        }
+
+        Rule rule;
+        rule.pattern = item["path"].asString();
+
+        std::string match = item.get("match", "exact").asString();
+        if (match == "exact") {
+            rule.match = Match::Exact;
+        } else if (match == "prefix") {
+            rule.match = Match::Prefix;
+        } else if (match == "glob") {
+            rule.match = Match::Glob;
+        } else {
+            AsyncLog::error() << "Route policy: unknown match type '" << match << "' for "
+                              << rule.pattern;
+            continue;
+        }
+
+        rule.decision = parseDecision(item.get("access", "public").asString(), Decision::Public);
+        rules.push_back(rule);
+    }
+
+    load(rules, defaultDecision);
+    AsyncLog::info() << "Route policy: " << ruleCount() << " rule(s) loaded";
+}
+
+bool RoutePolicy::globMatch(std::string_view pattern, std::string_view path) {
+    size_t p = 0, s = 0;
+    size_t starPattern = std::string_view::npos, starPath = 0;
+
+    while (s < path.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == path[s])) {
+            ++p;
+            ++s;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starPath = s;
+        } else if (starPattern != std::string_view::npos) {
+            // Let the last '*' swallow one more character and retry
+            p = starPattern + 1;
+            s = ++starPath;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+RoutePolicy::Decision RoutePolicy::decide(std::string_view path) const {
+    auto exact = std::lower_bound(_exact.begin(), _exact.end(), path,
+                                  [](const Rule& rule, std::string_view value) {
+                                      return std::string_view(rule.pattern) < value;
+                                  });
+    if (exact != _exact.end() && exact->pattern == path) {
+        return exact->decision;
+    }
+
+    for (const auto& rule : _prefix) {
+        if (path.size() >= rule.pattern.size() &&
+            path.compare(0, rule.pattern.size(), rule.pattern) == 0) {
+            return rule.decision;
+        }
+    }
+
+    for (const auto& rule : _glob) {
+        if (globMatch(rule.pattern, path)) {
+            return rule.decision;
+        }
+    }
+
+    return _default;
+}
@@ -0,0 +1,51 @@
+// RoutePolicy.h
+#pragma once
+#include <json/json.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Route access rules compiled once at startup and consulted by AuthFilter
+class RoutePolicy {
+public:
+    enum class Decision { Public, Authenticated };
+    enum class Match { Exact, Prefix, Glob };
+
+    struct Rule {
+        std::string pattern;
+        Match match = Match::Exact;
+        Decision decision = Decision::Public;
+    };
+
+    // Singleton instance
+    static RoutePolicy& getInstance();
+
+    RoutePolicy();
+
+    // Build the tables from a config section:
+    //   { "default": "authenticated",
+    //     "rules": [ { "path": "/css/", "match": "prefix", "access": "public" } ] }
+    // A missing or empty section keeps the built-in rules.
+    void load(const Json::Value& config);
+
+    // Build the tables from explicit rules
+    void load(const std::vector<Rule>& rules, Decision defaultDecision);
+
+    // Exact match wins, then the longest prefix, then the first glob, then the default.
+    // Does not allocate.
+    Decision decide(std::string_view path) const;
+
+    // Public pages, auth endpoints and static assets
+    static std::vector<Rule> defaultRules();
+
+    // '*' matches any run of characters (including '/'), '?' matches one character
+    static bool globMatch(std::string_view pattern, std::string_view path);
+
+    size_t ruleCount() const { return _exact.size() + _prefix.size() + _glob.size(); }
+
+private:
+    std::vector<Rule> _exact;   // Sorted by pattern for binary search
+    std::vector<Rule> _prefix;  // Longest pattern first
+    std::vector<Rule> _glob;    // Config order
+    Decision _default = Decision::Authenticated;
+};
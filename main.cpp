@@ -1,94 +1,287 @@
 #include <drogon/drogon.h>
+#include <chrono>
 #include <string>
-#include <iostream>
-#include "ViewLoader.h"
+#include <utility>
+#include <vector>
+#include "ViewCache.h"
+#include "AsyncLog.h"
+#include "ConfigReloader.h"
 #include "DatabaseConfig.h"
+#include "HashExecutor.h"
+#include "HealthMonitor.h"
+#include "Metrics.h"
+#include "RegisterBatcher.h"
+#include "ResponseCache.h"
+#include "SessionStore.h"
+#include "TokenAuth.h"
+#include "Tracer.h"
+#include "StaticAssets.h"
 #include "controllers/AuthController.h"
+#include "filters/AdminFilter.h"
 #include "filters/AuthFilter.h"
+#include "filters/RateLimiter.h"
+#include "filters/RoutePolicy.h"
+#include "models/UserCache.h"
 
 using namespace drogon;
 
+namespace {
+
+// Wall-clock time of each startup phase, printed just before the server starts
+class StartupTimer {
+public:
+    // Close the running phase (if any) and start the next one
+    void phase(const std::string& name) {
+        finish();
+        _current = name;
+        _started = std::chrono::steady_clock::now();
+    }
+
+    void report() {
+        finish();
+        double total = 0;
+        AsyncLog::info() << "Startup timing:";
+        for (const auto& [name, ms] : _phases) {
+            AsyncLog::info() << "  " << name << ": " << ms << " ms";
+            total += ms;
+        }
+        AsyncLog::info() << "  total: " << total << " ms";
+    }
+
+private:
+    void finish() {
+        if (_current.empty()) return;
+        auto elapsed = std::chrono::steady_clock::now() - _started;
+        _phases.emplace_back(_current, std::chrono::duration<double, std::milli>(elapsed).count());
+        _current.clear();
+    }
+
+    std::vector<std::pair<std::string, double>> _phases;
+    std::string _current;
+    std::chrono::steady_clock::time_point _started;
+};
+
+}
+
 int main() {
+    StartupTimer startup;
+
     // Debug: Check if PostgreSQL is defined
     #ifdef USE_POSTGRESQL
-        std::cout << "✓ USE_POSTGRESQL IS DEFINED!" << std::endl;
+        AsyncLog::info() << "✓ USE_POSTGRESQL IS DEFINED!";
     #else
-        std::cout << "✗ USE_POSTGRESQL IS NOT DEFINED!" << std::endl;
+        AsyncLog::info() << "✗ USE_POSTGRESQL IS NOT DEFINED!";
     #endif
 
-    std::cout << "==========================================" << std::endl;
-    std::cout << "Starting Drogon Application" << std::endl;
-    std::cout << "==========================================" << std::endl;
+    AsyncLog::info() << "==========================================";
+    AsyncLog::info() << "Starting Drogon Application";
+    AsyncLog::info() << "==========================================";
 
     // ========== INITIALIZE DATABASE FROM CONFIG.JSON ==========
-    std::cout << "\nStep 1: Initializing database..." << std::endl;
+    AsyncLog::info() << "\nStep 1: Initializing database...";
+    startup.phase("database (config parse + parallel connect/warm-up)");
     
     // Explicitly call initialize() first
     if (!DatabaseConfig::getInstance().initialize()) {
-        std::cout << "⚠ Database initialization failed or no database configured" << std::endl;
-        std::cout << "Server will start without database support" << std::endl;
+        AsyncLog::info() << "⚠ Database initialization failed or no database configured";
+        AsyncLog::info() << "Server will start without database support";
     } else {
-        std::cout << "✓ Database configuration loaded" << std::endl;
+        AsyncLog::info() << "✓ Database configuration loaded";
     }
 
-    // ========== TEST DATABASE CONNECTION ==========
-    std::cout << "\nStep 2: Testing database connection..." << std::endl;
-    auto dbClient = DatabaseConfig::getInstance().getClient();
+    // ========== CHECK DATABASE CONNECTION ==========
+    // Clients were connected and their pools warmed during initialize()
+    AsyncLog::info() << "\nStep 2: Checking database connection...";
+    // Not kept: a reload may replace the client, and holding it would keep its pool open
+    bool dbConnected = DatabaseConfig::getInstance().getClient() != nullptr;
     
-    if (dbClient) {
-        try {
-            auto result = dbClient->execSqlSync("SELECT version()");
-            std::cout << "✓ Database connected: PostgreSQL " 
-                      << result[0]["version"].as<std::string>().substr(0, 60) << std::endl;
-        } catch (const std::exception& e) {
-            std::cerr << "✗ Database connection test failed: " << e.what() << std::endl;
-            dbClient = nullptr;
-        }
+    if (dbConnected) {
+        AsyncLog::info() << "✓ Database connected";
     } else {
-        std::cout << "⚠ No database client available" << std::endl;
+        AsyncLog::info() << "⚠ No database client available";
     }
 
-    // Store for use in handlers
-    auto sharedDbClient = dbClient;
-
     // ========== LOAD DROGON CONFIGURATION ==========
-    std::cout << "\nStep 3: Loading server configuration..." << std::endl;
+    AsyncLog::info() << "\nStep 3: Loading server configuration...";
+    startup.phase("server configuration");
     try {
         std::string configPath = DatabaseConfig::getInstance().getConfigPath();
         if (!configPath.empty()) {
-            std::cout << "Loading from: " << configPath << std::endl;
+            AsyncLog::info() << "Loading from: " << configPath;
             app().loadConfigFile(configPath);
-            std::cout << "✓ Server configuration loaded" << std::endl;
+            AsyncLog::info() << "✓ Server configuration loaded";
         } else {
             // Fallback: Set up basic configuration
             app().addListener("0.0.0.0", 8080);
-            std::cout << "✓ Using default configuration (port 8080)" << std::endl;
+            AsyncLog::info() << "✓ Using default configuration (port 8080)";
         }
     } catch (const std::exception& e) {
-        std::cerr << "⚠ Error loading server config: " << e.what() << std::endl;
+        AsyncLog::error() << "⚠ Error loading server config: " << e.what();
         app().addListener("0.0.0.0", 8080); // Fallback
-        std::cout << "✓ Using fallback configuration (port 8080)" << std::endl;
+        AsyncLog::info() << "✓ Using fallback configuration (port 8080)";
     }
 
+    // Log files and the access log; lines logged so far went to the console only
+    AsyncLog::getInstance().configure(app().getCustomConfig()["logging"]);
+
     // ========== SETUP ROUTES ==========
-    std::cout << "\nStep 4: Setting up routes..." << std::endl;
+    AsyncLog::info() << "\nStep 4: Setting up routes...";
+    startup.phase("route setup");
+
+    // Public/authenticated route table used by AuthFilter
+    RoutePolicy::getInstance().load(app().getCustomConfig()["auth_routes"]);
+    // Users allowed through AdminFilter (listing, export, bulk import)
+    AdminFilter::configure(app().getCustomConfig()["admin"]);
+
+    // Per-route request counters and latency histograms
+    Metrics::getInstance().install();
+
+    // One access log record per request: method, path, status, latency, user
+    AsyncLog::getInstance().installAccessLog();
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& log = AsyncLog::getInstance();
+        out += "# TYPE drogonapp_log_records_written_total counter\n";
+        out += "drogonapp_log_records_written_total " + std::to_string(log.writtenCount()) + "\n";
+        out += "# TYPE drogonapp_log_records_dropped_total counter\n";
+        out += "drogonapp_log_records_dropped_total " + std::to_string(log.droppedCount()) + "\n";
+    });
+
+    // Sampled request tracing, written as a Chrome trace file
+    Tracer::getInstance().configure(app().getCustomConfig()["tracing"]);
+    Tracer::getInstance().install();
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& tracer = Tracer::getInstance();
+        out += "# TYPE drogonapp_traces_sampled_total counter\n";
+        out += "drogonapp_traces_sampled_total " + std::to_string(tracer.sampledCount()) + "\n";
+        out += "# TYPE drogonapp_trace_events_dropped_total counter\n";
+        out += "drogonapp_trace_events_dropped_total " + std::to_string(tracer.droppedCount()) + "\n";
+    });
+
+    // Profile cache for /api/me, filled on login and on first miss
+    UserCache::getInstance().configure(app().getCustomConfig()["user_cache"]);
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& cache = UserCache::getInstance();
+        out += "# TYPE drogonapp_user_cache_hits_total counter\n";
+        out += "drogonapp_user_cache_hits_total " + std::to_string(cache.hits()) + "\n";
+        out += "# TYPE drogonapp_user_cache_misses_total counter\n";
+        out += "drogonapp_user_cache_misses_total " + std::to_string(cache.misses()) + "\n";
+        out += "# TYPE drogonapp_user_cache_evictions_total counter\n";
+        out += "drogonapp_user_cache_evictions_total " + std::to_string(cache.evictions()) + "\n";
+        out += "# TYPE drogonapp_user_cache_entries gauge\n";
+        out += "drogonapp_user_cache_entries " + std::to_string(cache.size()) + "\n";
+    });
+
+    // Login sessions: sharded in-process store, expired by a timer wheel every second
+    SessionStore::getInstance().configure(app().getCustomConfig()["session_store"]);
+    app().getLoop()->runEvery(1.0, []() { SessionStore::getInstance().tick(); });
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& sessions = SessionStore::getInstance();
+        out += "# TYPE drogonapp_sessions gauge\n";
+        out += "drogonapp_sessions " + std::to_string(sessions.size()) + "\n";
+        out += "# TYPE drogonapp_sessions_expired_total counter\n";
+        out += "drogonapp_sessions_expired_total " + std::to_string(sessions.expiredCount()) + "\n";
+    });
+
+    // Optional stateless login: signed tokens instead of the session store
+    TokenAuth::getInstance().configure(app().getCustomConfig()["auth_token"]);
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& tokens = TokenAuth::getInstance();
+        out += "# TYPE drogonapp_auth_tokens_issued_total counter\n";
+        out += "drogonapp_auth_tokens_issued_total " + std::to_string(tokens.issuedCount()) + "\n";
+        out += "# TYPE drogonapp_auth_tokens_rejected_total counter\n";
+        out += "drogonapp_auth_tokens_rejected_total " + std::to_string(tokens.rejectedCount()) + "\n";
+    });
+
+    // Login/register limits per client IP and per account, idle buckets swept every second
+    RateLimiter::getInstance().configure(app().getCustomConfig()["rate_limit"]);
+    app().getLoop()->runEvery(1.0, []() { RateLimiter::getInstance().tick(); });
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& limiter = RateLimiter::getInstance();
+        out += "# TYPE drogonapp_rate_limit_allowed_total counter\n";
+        out += "drogonapp_rate_limit_allowed_total " + std::to_string(limiter.allowedCount()) + "\n";
+        out += "# TYPE drogonapp_rate_limit_rejected_total counter\n";
+        out += "drogonapp_rate_limit_rejected_total{key=\"ip\"} " + std::to_string(limiter.limitedIpCount()) + "\n";
+        out += "drogonapp_rate_limit_rejected_total{key=\"account\"} " + std::to_string(limiter.limitedAccountCount()) + "\n";
+        out += "# TYPE drogonapp_rate_limit_evicted_total counter\n";
+        out += "drogonapp_rate_limit_evicted_total " + std::to_string(limiter.evictedCount()) + "\n";
+        out += "# TYPE drogonapp_rate_limit_buckets gauge\n";
+        out += "drogonapp_rate_limit_buckets " + std::to_string(limiter.bucketCount()) + "\n";
+    });
+
+    // Password hashing runs on its own bounded pool, never on the IO loops
+    HashExecutor::getInstance().start(app().getCustomConfig()["hash_executor"]);
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& executor = HashExecutor::getInstance();
+        out += "# TYPE drogonapp_hash_queue_depth gauge\n";
+        out += "drogonapp_hash_queue_depth " + std::to_string(executor.queueDepth()) + "\n";
+        out += "# TYPE drogonapp_hash_jobs_completed_total counter\n";
+        out += "drogonapp_hash_jobs_completed_total " + std::to_string(executor.completed()) + "\n";
+        out += "# TYPE drogonapp_hash_jobs_rejected_total counter\n";
+        out += "drogonapp_hash_jobs_rejected_total " + std::to_string(executor.rejected()) + "\n";
+    });
+
+    // config.json changes (SIGHUP or file watch) rebuild the DB clients in the background
+    ConfigReloader::getInstance().start(app().getCustomConfig()["config_reload"]);
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& reloader = ConfigReloader::getInstance();
+        out += "# TYPE drogonapp_config_reloads_total counter\n";
+        out += "drogonapp_config_reloads_total{result=\"applied\"} " + std::to_string(reloader.reloadCount()) + "\n";
+        out += "drogonapp_config_reloads_total{result=\"failed\"} " + std::to_string(reloader.failedCount()) + "\n";
+        out += "# TYPE drogonapp_db_retired_snapshots gauge\n";
+        out += "drogonapp_db_retired_snapshots " + std::to_string(DatabaseConfig::getInstance().retiredCount()) + "\n";
+    });
+
+    // Concurrent /api/register inserts are coalesced into multi-row INSERTs
+    RegisterBatcher::getInstance().start(app().getCustomConfig()["register_batch"],
+        []() { return DatabaseConfig::getInstance().getClient(); });
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& batcher = RegisterBatcher::getInstance();
+        out += "# TYPE drogonapp_register_batches_total counter\n";
+        out += "drogonapp_register_batches_total " + std::to_string(batcher.batches()) + "\n";
+        out += "# TYPE drogonapp_register_rows_total counter\n";
+        out += "drogonapp_register_rows_total " + std::to_string(batcher.rows()) + "\n";
+        out += "# TYPE drogonapp_register_conflicts_total counter\n";
+        out += "drogonapp_register_conflicts_total " + std::to_string(batcher.conflicts()) + "\n";
+    });
+
+    // Precompressed, fingerprinted public/ files from the DrogonApp_assets build step;
+    // must be loaded before the views so they are rewritten to the fingerprinted URLs
+    if (StaticAssets::getInstance().initialize(app().getCustomConfig()["static_assets"])) {
+        StaticAssets::getInstance().registerRoutes();
+    }
+
+    // Views are read once here and re-read only when the files change
+    ViewCache::getInstance().initialize();
     
+    // Anonymous pages and /api/v1/info are answered from prebuilt, precompressed responses
+    ResponseCache::getInstance().configure(app().getCustomConfig()["response_cache"]);
+    Metrics::getInstance().addCollector([](std::string& out) {
+        auto& cache = ResponseCache::getInstance();
+        out += "# TYPE drogonapp_response_cache_requests_total counter\n";
+        out += "drogonapp_response_cache_requests_total{result=\"hit\"} " + std::to_string(cache.hits()) + "\n";
+        out += "drogonapp_response_cache_requests_total{result=\"stale\"} " + std::to_string(cache.staleHits()) + "\n";
+        out += "drogonapp_response_cache_requests_total{result=\"miss\"} " + std::to_string(cache.misses()) + "\n";
+        out += "# TYPE drogonapp_response_cache_coalesced_total counter\n";
+        out += "drogonapp_response_cache_coalesced_total " + std::to_string(cache.coalesced()) + "\n";
+        out += "# TYPE drogonapp_response_cache_builds_total counter\n";
+        out += "drogonapp_response_cache_builds_total " + std::to_string(cache.builds()) + "\n";
+    });
+
     // Home page
     app().registerHandler("/",
         [](const HttpRequestPtr& req,
            std::function<void(const HttpResponsePtr&)>&& callback) {
-            try {
-                std::string html = ViewLoader::loadView("home");
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setContentTypeCode(CT_TEXT_HTML);
-                resp->setBody(html);
-                callback(resp);
-            } catch (const std::exception& e) {
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setStatusCode(k404NotFound);
-                resp->setBody("Error: " + std::string(e.what()));
-                callback(resp);
-            }
+            // Prebuilt identity/gzip/brotli responses, rebuilt from the view once per TTL
+            ResponseCache::getInstance().serve(req, "/", {},
+                [](std::function<void(ResponseCache::Content)> done) {
+                    auto view = ViewCache::getInstance().getView("home");
+                    if (!view) {
+                        done({k404NotFound, CT_TEXT_PLAIN, "Error: View file not found: home.html"});
+                        return;
+                    }
+                    done({k200OK, CT_TEXT_HTML, *view});
+                },
+                std::move(callback));
         },
         {Get});
 
@@ -96,61 +289,72 @@ int main() {
     app().registerHandler("/login",
         [](const HttpRequestPtr& req,
            std::function<void(const HttpResponsePtr&)>&& callback) {
-            try {
-                std::string html = ViewLoader::loadView("login");
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setContentTypeCode(CT_TEXT_HTML);
-                resp->setBody(html);
-                callback(resp);
-            } catch (const std::exception& e) {
-                auto resp = HttpResponse::newHttpResponse();
-                resp->setStatusCode(k404NotFound);
-                resp->setBody("Error: " + std::string(e.what()));
-                callback(resp);
-            }
+            // Prebuilt identity/gzip/brotli responses, rebuilt from the view once per TTL
+            ResponseCache::getInstance().serve(req, "/login", {},
+                [](std::function<void(ResponseCache::Content)> done) {
+                    auto view = ViewCache::getInstance().getView("login");
+                    if (!view) {
+                        done({k404NotFound, CT_TEXT_PLAIN, "Error: View file not found: login.html"});
+                        return;
+                    }
+                    done({k200OK, CT_TEXT_HTML, *view});
+                },
+                std::move(callback));
         },
         {Get});
 
-    // Health check
+    // Health check: answers from the last background probe, ?deep=1 probes now
+    // (shared and rate limited, since the route is public)
+    HealthMonitor::getInstance().start();
     app().registerHandler("/health",
-        [sharedDbClient](const HttpRequestPtr& req,
+        [](const HttpRequestPtr& req,
            std::function<void(const HttpResponsePtr&)>&& callback) {
-            Json::Value json;
-            json["status"] = "ok";
-            json["service"] = "Drogon Web Server";
-            
-            if (sharedDbClient) {
-                json["database"] = "configured";
-                try {
-                    auto result = sharedDbClient->execSqlSync("SELECT 1 as test");
-                    json["database_test"] = "passed";
-                } catch (const std::exception& e) {
-                    json["database_test"] = "failed";
-                    json["database_error"] = e.what();
-                }
-            } else {
-                json["database"] = "not_configured";
+            if (req->getParameter("deep") == "1") {
+                HealthMonitor::getInstance().probeNow(2.0,
+                    [callback = std::move(callback)](Json::Value json) {
+                        json["mode"] = "deep";
+                        callback(HttpResponse::newHttpJsonResponse(json));
+                    });
+                return;
             }
             
+            auto json = HealthMonitor::getInstance().snapshot();
+            json["mode"] = "cached";
             auto resp = HttpResponse::newHttpJsonResponse(json);
             callback(resp);
         },
         {Get});
 
-    std::cout << "✓ Routes configured" << std::endl;
+    // Prometheus scrape endpoint
+    app().registerHandler("/metrics",
+        [](const HttpRequestPtr& req,
+           std::function<void(const HttpResponsePtr&)>&& callback) {
+            auto resp = HttpResponse::newHttpResponse();
+            resp->setContentTypeString("text/plain; version=0.0.4");
+            resp->setBody(Metrics::getInstance().scrape());
+            callback(resp);
+        },
+        {Get});
+
+    AsyncLog::info() << "✓ Routes configured";
+    startup.report();
 
     // ========== START SERVER ==========
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "      DROGON WEB SERVER v1.9.11" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << "Server running on http://localhost:8080" << std::endl;
-    std::cout << "Database: " << (dbClient ? "Connected ✓" : "Not available") << std::endl;
-    std::cout << "Health check: http://localhost:8080/health" << std::endl;
-    std::cout << "Press Ctrl+C to stop" << std::endl;
-    std::cout << std::string(60, '=') << "\n" << std::endl;
+    AsyncLog::info() << "\n" << std::string(60, '=');
+    AsyncLog::info() << "      DROGON WEB SERVER v1.9.11";
+    AsyncLog::info() << std::string(60, '=');
+    AsyncLog::info() << "Server running on http://localhost:8080";
+    AsyncLog::info() << "Database: " << (dbConnected ? "Connected ✓" : "Not available");
+    AsyncLog::info() << "Health check: http://localhost:8080/health";
+    AsyncLog::info() << "Press Ctrl+C to stop";
+    AsyncLog::info() << std::string(60, '=') << "\n";
     
     // Run the application
     app().run();
+
+    // Write out the last buffered spans
+    Tracer::getInstance().stop();
+    AsyncLog::getInstance().stop();
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+// UserCache.cpp
+#include "UserCache.h"
+#include "AsyncLog.h"
+#include <algorithm>
+
+UserCache& UserCache::getInstance() {
+    static UserCache instance;
+    return instance;
+}
+
+void UserCache::configure(size_t capacity, std::chrono::seconds ttl) {
+    clear();
+    _shardCapacity = std::max<size_t>(1, capacity / kShardCount);
+    _ttl = ttl;
+}
+
+void UserCache::configure(const Json::Value& config) {
+    size_t capacity = 10000;
+    int64_t ttlSeconds = 300;
+    if (config.isObject()) {
+        if (config["capacity"].isUInt()) capacity = config["capacity"].asUInt();
+        if (config["ttl_seconds"].isInt64()) ttlSeconds = config["ttl_seconds"].asInt64();
+    }
+
+    configure(capacity, std::chrono::seconds(ttlSeconds));
+    AsyncLog::info() << "User cache: capacity " << capacity << ", ttl " << ttlSeconds << "s";
+}
+
+std::shared_ptr<const User> UserCache::get(int userId) {
+    auto& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(userId);
+    if (it == shard.index.end()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (it->second->expiresAt <= Clock::now()) {
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second->user;
+}
+
+void UserCache::put(const User& user) {
+    auto cached = std::make_shared<const User>(user);
+    auto expiresAt = Clock::now() + _ttl;
+    int userId = user.getId();
+
+    auto& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(userId);
+    if (it != shard.index.end()) {
+        it->second->user = std::move(cached);
+        it->second->expiresAt = expiresAt;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    shard.lru.push_front(Node{userId, std::move(cached), expiresAt});
+    shard.index[userId] = shard.lru.begin();
+
+    if (shard.lru.size() > _shardCapacity) {
+        shard.index.erase(shard.lru.back().userId);
+        shard.lru.pop_back();
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void UserCache::invalidate(int userId) {
+    auto& shard = shardFor(userId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(userId);
+    if (it != shard.index.end()) {
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+}
+
+void UserCache::clear() {
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.lru.clear();
+        shard.index.clear();
+    }
+}
+
+size_t UserCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.lru.size();
+    }
+    return total;
+}
@@ -0,0 +1,69 @@
+// UserCache.h
+#pragma once
+#include "User.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Sharded LRU cache of user profiles with a TTL, keyed by user id
+class UserCache {
+public:
+    // Singleton instance
+    static UserCache& getInstance();
+
+    // Set total capacity and entry lifetime; clears the cache
+    void configure(size_t capacity, std::chrono::seconds ttl);
+
+    // Configure from a config section: { "capacity": 10000, "ttl_seconds": 300 }
+    void configure(const Json::Value& config);
+
+    // Cached profile, or nullptr on miss / expiry
+    std::shared_ptr<const User> get(int userId);
+
+    // Insert or refresh a profile
+    void put(const User& user);
+
+    // Drop a profile; call from every path that writes the users table
+    void invalidate(int userId);
+
+    void clear();
+
+    uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+    uint64_t evictions() const { return _evictions.load(std::memory_order_relaxed); }
+    size_t size() const;
+
+private:
+    UserCache() = default;
+    UserCache(const UserCache&) = delete;
+    UserCache& operator=(const UserCache&) = delete;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        int userId;
+        std::shared_ptr<const User> user;
+        Clock::time_point expiresAt;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Node> lru; // Most recently used first
+        std::unordered_map<int, std::list<Node>::iterator> index;
+    };
+
+    static constexpr size_t kShardCount = 16;
+
+    Shard& shardFor(int userId) { return _shards[static_cast<unsigned>(userId) % kShardCount]; }
+
+    std::array<Shard, kShardCount> _shards;
+    size_t _shardCapacity = 10000 / kShardCount;
+    Clock::duration _ttl = std::chrono::seconds(300);
+    std::atomic<uint64_t> _hits{0};
+    std::atomic<uint64_t> _misses{0};
+    std::atomic<uint64_t> _evictions{0};
+};
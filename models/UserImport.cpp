@@ -0,0 +1,388 @@
+// UserImport.cpp
+#include "UserImport.h"
+#include "HashExecutor.h"
+#include <libpq-fe.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <future>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+namespace {
+
+// Column limits of the users table
+constexpr size_t kMaxUsername = 50;
+constexpr size_t kMaxEmail = 100;
+
+// Import slices queued or running on HashExecutor, across all imports. Capped so
+// that logins and signups keep workers and queue room while an import runs.
+std::atomic<size_t> sharedSlices{0};
+
+const char* kCreateStagingSql =
+    "CREATE TEMP TABLE user_import_staging ("
+    "line_no BIGINT, username TEXT, email TEXT, password_hash TEXT)";
+
+// Earlier lines win a username/email; lines whose insert was skipped are returned
+const char* kInsertFromStagingSql =
+    "WITH inserted AS ("
+    "INSERT INTO users (username, email, password_hash) "
+    "SELECT username, email, password_hash FROM user_import_staging ORDER BY line_no "
+    "ON CONFLICT DO NOTHING RETURNING username) "
+    "SELECT s.line_no FROM user_import_staging s "
+    "WHERE NOT EXISTS (SELECT 1 FROM inserted i WHERE i.username = s.username) "
+    "ORDER BY s.line_no";
+
+std::string lowercase(std::string_view text) {
+    std::string out(text);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+// Split one CSV record (RFC 4180 quoting, no embedded newlines)
+bool splitCsv(std::string_view line, std::vector<std::string>& fields) {
+    fields.clear();
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field.push_back('"');
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field.push_back(c);
+            }
+        } else if (c == '"' && field.empty()) {
+            quoted = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else {
+            field.push_back(c);
+        }
+    }
+    fields.push_back(std::move(field));
+    return !quoted;
+}
+
+// COPY text format: backslash, tab and line breaks must be escaped
+void appendCopyField(std::string& out, const std::string& value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out.push_back(c);
+        }
+    }
+}
+
+std::string connectionError(PGconn* conn) {
+    std::string error = PQerrorMessage(conn);
+    while (!error.empty() && (error.back() == '\n' || error.back() == ' ')) error.pop_back();
+    return error;
+}
+
+}
+
+UserImport::Options UserImport::optionsFromConfig(const Json::Value& config) {
+    Options options;
+    if (!config.isObject()) return options;
+    if (config["chunk_rows"].isUInt()) options.chunkRows = std::max(1u, config["chunk_rows"].asUInt());
+    if (config["hash_threads"].isUInt()) options.hashThreads = std::max(1u, config["hash_threads"].asUInt());
+    if (config["shared_hash_slices"].isUInt()) options.sharedHashSlices = config["shared_hash_slices"].asUInt();
+    if (config["max_reported_errors"].isUInt()) options.maxReportedErrors = config["max_reported_errors"].asUInt();
+    return options;
+}
+
+UserImport::UserImport(std::string connInfo, Format format, Options options)
+    : _connInfo(std::move(connInfo)), _format(format), _options(options) {
+    Json::CharReaderBuilder builder;
+    _jsonReader.reset(builder.newCharReader());
+    _chunk.reserve(_options.chunkRows);
+}
+
+UserImport::~UserImport() {
+    if (_conn) PQfinish(_conn);
+}
+
+bool UserImport::connect(std::string& error) {
+    _conn = PQconnectdb(_connInfo.c_str());
+    if (PQstatus(_conn) != CONNECTION_OK) {
+        error = connectionError(_conn);
+        return false;
+    }
+    _connected = exec(kCreateStagingSql, error);
+    return _connected;
+}
+
+bool UserImport::exec(const char* sql, std::string& error) {
+    PGresult* result = PQexec(_conn, sql);
+    bool ok = PQresultStatus(result) == PGRES_COMMAND_OK || PQresultStatus(result) == PGRES_TUPLES_OK;
+    if (!ok) error = connectionError(_conn);
+    PQclear(result);
+    return ok;
+}
+
+void UserImport::addError(size_t line, const std::string& error) {
+    ++_failed;
+    if (_errors.size() >= _options.maxReportedErrors) return;
+    Json::Value entry;
+    entry["line"] = static_cast<Json::UInt64>(line);
+    entry["error"] = error;
+    _errors.append(entry);
+}
+
+Json::Value UserImport::run(std::string_view body) {
+    Json::Value report;
+    std::string error;
+    if (!connect(error)) {
+        report["error"] = "Database connection failed: " + error;
+        return report;
+    }
+
+    size_t lineNo = 0;
+    size_t pos = 0;
+    while (pos < body.size()) {
+        size_t end = body.find('\n', pos);
+        if (end == std::string_view::npos) end = body.size();
+        std::string_view line = body.substr(pos, end - pos);
+        pos = end + 1;
+        ++lineNo;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+
+        if (_format == Format::kCsv && !_haveHeader) {
+            if (!parseCsvHeader(line, error)) {
+                report["error"] = error;
+                return report;
+            }
+            continue;
+        }
+
+        ++_rows;
+        Row row;
+        row.line = lineNo;
+        if (!parseLine(line, row, error)) {
+            addError(lineNo, error);
+            continue;
+        }
+        _chunk.push_back(std::move(row));
+        if (_chunk.size() >= _options.chunkRows) flushChunk();
+    }
+    flushChunk();
+
+    report["rows"] = static_cast<Json::UInt64>(_rows);
+    report["created"] = static_cast<Json::UInt64>(_created);
+    report["failed"] = static_cast<Json::UInt64>(_failed);
+    report["errors"] = _errors;
+    if (_failed > _errors.size()) {
+        report["errors_truncated"] = true;
+    }
+    return report;
+}
+
+bool UserImport::parseCsvHeader(std::string_view line, std::string& error) {
+    std::vector<std::string> fields;
+    if (!splitCsv(line, fields)) {
+        error = "Malformed CSV header";
+        return false;
+    }
+    for (size_t i = 0; i < fields.size(); ++i) {
+        auto name = lowercase(fields[i]);
+        if (name == "username") _usernameColumn = static_cast<int>(i);
+        else if (name == "email") _emailColumn = static_cast<int>(i);
+        else if (name == "password") _passwordColumn = static_cast<int>(i);
+    }
+    if (_usernameColumn < 0 || _emailColumn < 0 || _passwordColumn < 0) {
+        error = "CSV header must name username, email and password columns";
+        return false;
+    }
+    _haveHeader = true;
+    return true;
+}
+
+bool UserImport::parseLine(std::string_view line, Row& row, std::string& error) {
+    if (_format == Format::kNdjson) {
+        Json::Value json;
+        std::string parseErrors;
+        if (!_jsonReader->parse(line.data(), line.data() + line.size(), &json, &parseErrors) ||
+            !json.isObject()) {
+            error = "Invalid JSON object";
+            return false;
+        }
+        if (!json["username"].isString() || !json["email"].isString() || !json["password"].isString()) {
+            error = "Missing fields";
+            return false;
+        }
+        row.username = json["username"].asString();
+        row.email = json["email"].asString();
+        row.password = json["password"].asString();
+    } else {
+        std::vector<std::string> fields;
+        if (!splitCsv(line, fields)) {
+            error = "Unterminated quoted field";
+            return false;
+        }
+        size_t needed = static_cast<size_t>(std::max({_usernameColumn, _emailColumn, _passwordColumn})) + 1;
+        if (fields.size() < needed) {
+            error = "Missing fields";
+            return false;
+        }
+        row.username = std::move(fields[_usernameColumn]);
+        row.email = std::move(fields[_emailColumn]);
+        row.password = std::move(fields[_passwordColumn]);
+    }
+
+    if (row.username.empty() || row.username.size() > kMaxUsername) {
+        error = "Username must be 1-" + std::to_string(kMaxUsername) + " characters";
+        return false;
+    }
+    if (row.email.size() > kMaxEmail || row.email.find('@') == std::string::npos) {
+        error = "Invalid email";
+        return false;
+    }
+    if (row.password.empty()) {
+        error = "Missing password";
+        return false;
+    }
+    return true;
+}
+
+void UserImport::flushChunk() {
+    if (_chunk.empty()) return;
+
+    // Within a chunk the first line wins a username or email; later ones would
+    // otherwise be indistinguishable from each other after the insert
+    std::unordered_set<std::string> usernames;
+    std::unordered_set<std::string> emails;
+    std::vector<Row> rows;
+    rows.reserve(_chunk.size());
+    for (auto& row : _chunk) {
+        if (!usernames.insert(row.username).second || !emails.insert(row.email).second) {
+            addError(row.line, "Duplicate username or email in upload");
+            continue;
+        }
+        rows.push_back(std::move(row));
+    }
+    _chunk.clear();
+
+    // Hash slices of the chunk in parallel: up to sharedHashSlices (for all imports
+    // together) on the hash workers that /api/register also uses, the rest on this
+    // thread, as is a slice the queue has no room for.
+    auto hashSlice = [&rows](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rows[i].passwordHash = HashExecutor::computeHash(rows[i].password);
+            rows[i].password.clear();
+        }
+        return true;
+    };
+    size_t slices = std::max<size_t>(1, std::min(_options.hashThreads, rows.size()));
+    size_t slice = (rows.size() + slices - 1) / slices;
+    std::vector<std::future<bool>> hashing;
+    for (size_t begin = 0; begin < rows.size(); begin += slice) {
+        size_t end = std::min(rows.size(), begin + slice);
+        auto hashed = std::make_shared<std::promise<bool>>();
+        hashing.push_back(hashed->get_future());
+        bool queued = false;
+        if (sharedSlices.fetch_add(1) < _options.sharedHashSlices) {
+            queued = HashExecutor::getInstance().submit<bool>(
+                nullptr,
+                [hashSlice, begin, end]() { return hashSlice(begin, end); },
+                [hashed](std::optional<bool> ok) {
+                    sharedSlices.fetch_sub(1);
+                    hashed->set_value(ok.value_or(false));
+                });
+        }
+        if (!queued) {
+            sharedSlices.fetch_sub(1);
+            hashed->set_value(hashSlice(begin, end));
+        }
+    }
+    bool hashedAll = true;
+    for (auto& job : hashing) hashedAll = job.get() && hashedAll;
+
+    // A failed slice leaves its rows unhashed
+    _chunk.clear();
+    for (auto& row : rows) {
+        if (!hashedAll && row.passwordHash.empty()) {
+            addError(row.line, "Password hashing failed");
+            continue;
+        }
+        _chunk.push_back(std::move(row));
+    }
+    if (_chunk.empty()) return;
+    std::string error;
+    if (!copyChunk(error)) {
+        std::string ignored;
+        exec("ROLLBACK", ignored);
+        for (const auto& row : _chunk) addError(row.line, "Import failed: " + error);
+    }
+    _chunk.clear();
+}
+
+bool UserImport::copyChunk(std::string& error) {
+    if (!exec("BEGIN", error) || !exec("TRUNCATE user_import_staging", error)) return false;
+
+    PGresult* result = PQexec(_conn, "COPY user_import_staging (line_no, username, email, password_hash) FROM STDIN");
+    bool copying = PQresultStatus(result) == PGRES_COPY_IN;
+    PQclear(result);
+    if (!copying) {
+        error = connectionError(_conn);
+        return false;
+    }
+
+    _copyBuffer.clear();
+    for (const auto& row : _chunk) {
+        _copyBuffer += std::to_string(row.line);
+        _copyBuffer.push_back('\t');
+        appendCopyField(_copyBuffer, row.username);
+        _copyBuffer.push_back('\t');
+        appendCopyField(_copyBuffer, row.email);
+        _copyBuffer.push_back('\t');
+        appendCopyField(_copyBuffer, row.passwordHash);
+        _copyBuffer.push_back('\n');
+    }
+
+    bool sent = PQputCopyData(_conn, _copyBuffer.data(), static_cast<int>(_copyBuffer.size())) == 1;
+    if (PQputCopyEnd(_conn, sent ? nullptr : "client error") != 1) {
+        error = connectionError(_conn);
+        return false;
+    }
+    bool copied = true;
+    while ((result = PQgetResult(_conn)) != nullptr) {
+        if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+            copied = false;
+            error = connectionError(_conn);
+        }
+        PQclear(result);
+    }
+    if (!copied) return false;
+
+    result = PQexec(_conn, kInsertFromStagingSql);
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        error = connectionError(_conn);
+        PQclear(result);
+        return false;
+    }
+    size_t skipped = static_cast<size_t>(PQntuples(result));
+    std::vector<size_t> skippedLines;
+    skippedLines.reserve(skipped);
+    for (size_t i = 0; i < skipped; ++i) {
+        skippedLines.push_back(std::stoull(PQgetvalue(result, static_cast<int>(i), 0)));
+    }
+    PQclear(result);
+
+    if (!exec("COMMIT", error)) return false;
+
+    _created += _chunk.size() - skipped;
+    for (size_t line : skippedLines) addError(line, "Username or email already exists");
+    return true;
+}
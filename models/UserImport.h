@@ -0,0 +1,89 @@
+// UserImport.h
+#pragma once
+#include <json/json.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct pg_conn;
+
+// Bulk user import behind POST /api/v1/users.
+// The body is parsed a line at a time; every chunk of rows is validated, hashed
+// in parallel and sent with COPY ... FROM STDIN into a staging table, then moved
+// into users with ON CONFLICT DO NOTHING. Only one chunk is held in memory, and
+// the report keeps at most maxReportedErrors row errors.
+class UserImport {
+public:
+    enum class Format { kNdjson, kCsv };
+
+    struct Options {
+        size_t chunkRows = 1000;
+        size_t hashThreads = 2;         // Slices a chunk is hashed in
+        size_t sharedHashSlices = 1;    // Import slices on HashExecutor at once, across all imports;
+                                        // the rest are hashed on the import's own thread
+        size_t maxReportedErrors = 1000;
+    };
+
+    // Options from a config section:
+    //   { "chunk_rows": 1000, "hash_threads": 2, "shared_hash_slices": 1, "max_reported_errors": 1000 }
+    // The upload is bounded by drogon's app.client_max_body_size, which applies to
+    // every route (1M by default). Deployments that import large files raise it
+    // themselves, knowing that it also raises the limit for public endpoints.
+    static Options optionsFromConfig(const Json::Value& config);
+
+    UserImport(std::string connInfo, Format format, Options options);
+    ~UserImport();
+
+    // Import every row of body and return the report:
+    //   { "rows": n, "created": n, "failed": n, "errors": [{ "line": n, "error": "..." }] }
+    // Blocking; run it off the IO loops.
+    Json::Value run(std::string_view body);
+
+    // False if run() could not reach the database
+    bool connected() const { return _connected; }
+
+private:
+    struct Row {
+        size_t line = 0;
+        std::string username;
+        std::string email;
+        std::string password;
+        std::string passwordHash;
+    };
+
+    bool connect(std::string& error);
+    bool exec(const char* sql, std::string& error);
+
+    // Parse one non-empty line into row; false with error set if it is invalid
+    bool parseLine(std::string_view line, Row& row, std::string& error);
+    bool parseCsvHeader(std::string_view line, std::string& error);
+
+    // Hash, COPY and insert the pending chunk, recording failures
+    void flushChunk();
+    bool copyChunk(std::string& error);
+
+    void addError(size_t line, const std::string& error);
+
+    std::string _connInfo;
+    Format _format;
+    Options _options;
+    pg_conn* _conn = nullptr;
+    bool _connected = false;
+
+    // CSV column positions, from the header line
+    int _usernameColumn = -1;
+    int _emailColumn = -1;
+    int _passwordColumn = -1;
+    bool _haveHeader = false;
+
+    std::vector<Row> _chunk;
+    std::string _copyBuffer;
+    std::unique_ptr<Json::CharReader> _jsonReader;
+
+    size_t _rows = 0;
+    size_t _created = 0;
+    size_t _failed = 0;
+    Json::Value _errors{Json::arrayValue};
+};
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <drogon/drogon.h>
 #include <string>
+#include "JsonWriter.h"
 
 class User {
 public:
@@ -10,8 +11,8 @@ public:
         : id(id), username(username), email(email) {}
 
     int getId() const { return id; }
-    std::string getUsername() const { return username; }
-    std::string getEmail() const { return email; }
+    const std::string& getUsername() const { return username; }
+    const std::string& getEmail() const { return email; }
 
     static User fromJson(const Json::Value& json);
     Json::Value toJson() const;
@@ -21,3 +22,12 @@ private:
     std::string username;
     std::string email;
 };
+
+// Same fields as toJson(), written without building a Json::Value
+template <>
+struct JsonSchema<User> {
+    static constexpr auto fields = std::make_tuple(
+        jsonField("id", &User::getId),
+        jsonField("username", &User::getUsername),
+        jsonField("email", &User::getEmail));
+};
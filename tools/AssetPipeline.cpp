@@ -0,0 +1,254 @@
+// AssetPipeline.cpp - build step producing the fingerprinted, precompressed copy of public/
+//
+// Usage: DrogonApp_assets <public dir> <output dir>
+//
+// Every file under <public dir> is written to <output dir> under a content-hashed
+// name (css/bootstrap.min.css -> css/bootstrap.min.<hash>.css), together with .gz
+// and .br variants when compressing pays off. url(...) references inside CSS are
+// rewritten to the fingerprinted names first, so a font change also changes the
+// hash of the stylesheet that uses it. asset-manifest.json maps each original URL
+// to its fingerprinted file; StaticAssets loads it at startup.
+#include <brotli/encode.h>
+#include <json/json.h>
+#include <openssl/evp.h>
+#include <zlib.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kFingerprintHexChars = 16;
+
+struct FileType {
+    const char* extension;
+    const char* contentType;
+    bool compressible;      // Already-compressed formats (woff2, png) are left alone
+};
+
+const FileType kFileTypes[] = {
+    {".css", "text/css; charset=utf-8", true},
+    {".js", "application/javascript; charset=utf-8", true},
+    {".json", "application/json", true},
+    {".map", "application/json", true},
+    {".svg", "image/svg+xml", true},
+    {".txt", "text/plain; charset=utf-8", true},
+    {".html", "text/html; charset=utf-8", true},
+    {".woff2", "font/woff2", false},
+    {".woff", "font/woff", false},
+    {".png", "image/png", false},
+    {".jpg", "image/jpeg", false},
+    {".ico", "image/x-icon", true},
+};
+
+const FileType kUnknownType = {"", "application/octet-stream", false};
+
+const FileType& fileTypeOf(const fs::path& path) {
+    auto extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const auto& type : kFileTypes) {
+        if (extension == type.extension) return type;
+    }
+    return kUnknownType;
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+bool writeFile(const fs::path& path, const std::string& data) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+std::string sha256Hex(const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(data.data(), data.size(), digest, &length, EVP_sha256(), nullptr);
+
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned int i = 0; i < length; ++i) {
+        hex.push_back(kHex[digest[i] >> 4]);
+        hex.push_back(kHex[digest[i] & 0xF]);
+    }
+    return hex;
+}
+
+std::string gzipCompress(const std::string& data) {
+    z_stream stream{};
+    // 15 + 16: deflate window with a gzip header
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+    std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END ? out : std::string();
+}
+
+std::string brotliCompress(const std::string& data, bool text) {
+    size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    if (size == 0) return {};
+    std::string out(size, '\0');
+    bool ok = BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW,
+                                    text ? BROTLI_MODE_TEXT : BROTLI_MODE_GENERIC,
+                                    data.size(), reinterpret_cast<const uint8_t*>(data.data()),
+                                    &size, reinterpret_cast<uint8_t*>(out.data()));
+    if (!ok) return {};
+    out.resize(size);
+    return out;
+}
+
+// "/css/fonts/../x.woff2" -> "/css/x.woff2"
+std::string normalizeUrl(const std::string& url) {
+    return fs::path(url).lexically_normal().generic_string();
+}
+
+// Point url(...) references at fingerprinted files; anything unknown stays as it is
+std::string rewriteCssUrls(const std::string& css, const std::string& cssUrl,
+                           const std::map<std::string, std::string>& fingerprinted) {
+    std::string baseDirectory = cssUrl.substr(0, cssUrl.rfind('/') + 1);
+    std::string out;
+    out.reserve(css.size());
+    size_t pos = 0;
+    while (true) {
+        size_t open = css.find("url(", pos);
+        size_t close = open == std::string::npos ? std::string::npos : css.find(')', open);
+        if (close == std::string::npos) break;
+
+        std::string target = css.substr(open + 4, close - open - 4);
+        target.erase(0, target.find_first_not_of(" \t\"'"));
+        target.erase(target.find_last_not_of(" \t\"'") + 1);
+
+        // Cache-busting query strings are superseded by the fingerprint; fragments are kept
+        size_t fragmentAt = target.find('#');
+        std::string fragment = fragmentAt == std::string::npos ? "" : target.substr(fragmentAt);
+        std::string file = target.substr(0, std::min(target.find('?'), fragmentAt));
+
+        out.append(css, pos, open - pos);
+        bool local = !file.empty() && file.find(':') == std::string::npos && file.compare(0, 2, "//") != 0;
+        auto it = local ? fingerprinted.find(normalizeUrl(file[0] == '/' ? file : baseDirectory + file))
+                        : fingerprinted.end();
+        if (it != fingerprinted.end()) {
+            out += "url(\"" + it->second + fragment + "\")";
+        } else {
+            out.append(css, open, close + 1 - open);
+        }
+        pos = close + 1;
+    }
+    out.append(css, pos, std::string::npos);
+    return out;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <public dir> <output dir>" << std::endl;
+        return 2;
+    }
+    fs::path sourceDirectory = argv[1];
+    fs::path outputDirectory = argv[2];
+
+    std::error_code ec;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator(sourceDirectory, ec)) {
+        if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    if (ec) {
+        std::cerr << "Asset pipeline: cannot read " << sourceDirectory.string() << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    // Stylesheets last: their url(...) targets must be fingerprinted before them
+    std::stable_sort(files.begin(), files.end(), [](const fs::path& a, const fs::path& b) {
+        return (fileTypeOf(a).extension == std::string(".css")) < (fileTypeOf(b).extension == std::string(".css"));
+    });
+
+    // Start clean so stale fingerprints do not pile up
+    fs::remove_all(outputDirectory, ec);
+    fs::create_directories(outputDirectory, ec);
+
+    std::map<std::string, std::string> fingerprinted;
+    Json::Value assets(Json::arrayValue);
+    for (const auto& path : files) {
+        auto relative = path.lexically_relative(sourceDirectory);
+        std::string url = "/" + relative.generic_string();
+        const auto& type = fileTypeOf(path);
+
+        std::string content = readFile(path);
+        if (type.extension == std::string(".css")) {
+            content = rewriteCssUrls(content, url, fingerprinted);
+        }
+
+        std::string hash = sha256Hex(content).substr(0, kFingerprintHexChars);
+        auto fingerprintedPath = relative;
+        fingerprintedPath.replace_filename(relative.stem().string() + "." + hash + relative.extension().string());
+        fingerprinted[url] = "/" + fingerprintedPath.generic_string();
+
+        if (!writeFile(outputDirectory / fingerprintedPath, content)) {
+            std::cerr << "Asset pipeline: cannot write " << (outputDirectory / fingerprintedPath).string() << std::endl;
+            return 1;
+        }
+
+        Json::Value asset;
+        asset["url"] = url;
+        asset["path"] = fingerprintedPath.generic_string();
+        asset["content_type"] = type.contentType;
+        asset["hash"] = hash;
+        asset["encodings"] = Json::Value(Json::arrayValue);
+
+        std::cout << url << " -> " << fingerprinted[url] << " (identity " << content.size();
+        if (type.compressible) {
+            // Variants are only kept when they are actually smaller
+            std::pair<const char*, std::string> variants[] = {
+                {"br", brotliCompress(content, true)},
+                {"gzip", gzipCompress(content)},
+            };
+            for (const auto& [encoding, data] : variants) {
+                if (data.empty() || data.size() >= content.size()) continue;
+                std::string suffix = std::string(encoding) == "br" ? ".br" : ".gz";
+                auto variantPath = outputDirectory / fingerprintedPath;
+                variantPath += suffix;
+                if (!writeFile(variantPath, data)) {
+                    std::cerr << "Asset pipeline: cannot write " << variantPath.string() << std::endl;
+                    return 1;
+                }
+                asset["encodings"].append(encoding);
+                std::cout << ", " << encoding << " " << data.size();
+            }
+        }
+        std::cout << ")" << std::endl;
+        assets.append(asset);
+    }
+
+    Json::Value manifest;
+    manifest["version"] = 1;
+    manifest["assets"] = assets;
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    if (!writeFile(outputDirectory / "asset-manifest.json", Json::writeString(builder, manifest))) {
+        std::cerr << "Asset pipeline: cannot write the manifest" << std::endl;
+        return 1;
+    }
+    std::cout << "Asset pipeline: " << assets.size() << " asset(s) written to " << outputDirectory.string() << std::endl;
+    return 0;
+}